@@ -122,17 +122,28 @@ void AxisEvent::send(UInput& uinput, int value) {
   }
 }
 
-void AxisEvent::update(UInput& uinput, int msec_delta) {
+void AxisEvent::update(UInput& uinput, int64_t nsec_delta) {
   for (std::vector<AxisFilterPtr>::const_iterator i = m_filters.begin();
        i != m_filters.end(); ++i) {
-    (*i)->update(msec_delta);
+    (*i)->update(nsec_delta);
   }
 
-  m_handler->update(uinput, msec_delta);
+  m_handler->update(uinput, nsec_delta);
 
   send(uinput, m_last_raw_value);
 }
 
+bool AxisEvent::needs_update() const {
+  for (std::vector<AxisFilterPtr>::const_iterator i = m_filters.begin();
+       i != m_filters.end(); ++i) {
+    if ((*i)->needs_update()) {
+      return true;
+    }
+  }
+
+  return m_handler->needs_update();
+}
+
 void AxisEvent::set_axis_range(int min, int max) {
   m_min = min;
   m_max = max;
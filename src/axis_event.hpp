@@ -52,7 +52,8 @@ class AxisEvent {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, int value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta);
+  bool needs_update() const;
 
   void set_axis_range(int min, int max);
 
@@ -78,7 +79,11 @@ class AxisEventHandler {
 
   virtual void init(UInput& uinput, int slot, bool extra_devices) = 0;
   virtual void send(UInput& uinput, int value) = 0;
-  virtual void update(UInput& uinput, int msec_delta) = 0;
+  virtual void update(UInput& uinput, int64_t nsec_delta) = 0;
+
+  /** Returns true while update() does something, so that it only has
+      to be called periodically while it does */
+  virtual bool needs_update() const { return false; }
 
   virtual void set_axis_range(int min, int max);
 
@@ -19,6 +19,7 @@
 #ifndef HEADER_XBOXDRV_AXIS_FILTER_HPP
 #define HEADER_XBOXDRV_AXIS_FILTER_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -35,7 +36,11 @@ class AxisFilter {
   AxisFilter() {}
   virtual ~AxisFilter() {}
 
-  virtual void update(int msec_delta) {}
+  virtual void update(int64_t nsec_delta) {}
+
+  /** Returns true while the output of the filter changes over time,
+      update() only has to be called periodically while it does */
+  virtual bool needs_update() const { return false; }
   virtual int filter(int value, int min, int max) = 0;
   virtual std::string str() const = 0;
 };
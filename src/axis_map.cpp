@@ -54,14 +54,25 @@ void AxisMap::init(UInput& uinput, int slot, bool extra_devices) const {
   }
 }
 
-void AxisMap::update(UInput& uinput, int msec_delta) {
+void AxisMap::update(UInput& uinput, int64_t nsec_delta) {
   for (int shift_code = 0; shift_code < XBOX_BTN_MAX; ++shift_code) {
     for (int code = 0; code < XBOX_AXIS_MAX; ++code) {
       if (m_axis_map[shift_code][code]) {
-        m_axis_map[shift_code][code]->update(uinput, msec_delta);
+        m_axis_map[shift_code][code]->update(uinput, nsec_delta);
       }
     }
   }
 }
 
+bool AxisMap::needs_update() const {
+  for (int shift_code = 0; shift_code < XBOX_BTN_MAX; ++shift_code) {
+    for (int code = 0; code < XBOX_AXIS_MAX; ++code) {
+      if (m_axis_map[shift_code][code] && m_axis_map[shift_code][code]->needs_update()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 /* EOF */
@@ -79,7 +79,7 @@ void AbsAxisEventHandler::send(UInput& uinput, int value) {
   m_abs_emitter->send(value);
 }
 
-void AbsAxisEventHandler::update(UInput& uinput, int msec_delta) {}
+void AbsAxisEventHandler::update(UInput& uinput, int64_t nsec_delta) {}
 
 std::string AbsAxisEventHandler::str() const {
   std::ostringstream out;
@@ -35,7 +35,7 @@ class AbsAxisEventHandler : public AxisEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, int value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta);
 
   std::string str() const;
 
@@ -121,7 +121,7 @@ void KeyAxisEventHandler::send(UInput& uinput, int value) {
   m_old_value = value;
 }
 
-void KeyAxisEventHandler::update(UInput& uinput, int msec_delta) {}
+void KeyAxisEventHandler::update(UInput& uinput, int64_t nsec_delta) {}
 
 std::string KeyAxisEventHandler::str() const {
   std::ostringstream out;
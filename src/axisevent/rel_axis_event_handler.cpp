@@ -18,7 +18,6 @@
 
 #include "axisevent/rel_axis_event_handler.hpp"
 
-#include <cmath>
 #include <memory>
 #include <stdexcept>
 
@@ -67,8 +66,7 @@ RelAxisEventHandler::RelAxisEventHandler()
       m_value(5),
       m_repeat(10),
       m_stick_value(0.0f),
-      m_rest_value(0.0f),
-      m_rel_emitter() {}
+      m_rel_repeat(-1) {}
 
 RelAxisEventHandler::RelAxisEventHandler(int device_id, int code, int repeat,
                                          float value)
@@ -76,12 +74,12 @@ RelAxisEventHandler::RelAxisEventHandler(int device_id, int code, int repeat,
       m_value(value),
       m_repeat(repeat),
       m_stick_value(0.0f),
-      m_rest_value(0.0f),
-      m_rel_emitter() {}
+      m_rel_repeat(-1) {}
 
 void RelAxisEventHandler::init(UInput& uinput, int slot, bool extra_devices) {
   m_code.resolve_device_id(slot, extra_devices);
-  m_rel_emitter = uinput.add_rel(m_code.get_device_id(), m_code.code);
+  uinput.add_rel(m_code.get_device_id(), m_code.code);
+  m_rel_repeat = uinput.add_rel_repeat(m_code);
 }
 
 void RelAxisEventHandler::send(UInput& uinput, int value) {
@@ -95,24 +93,13 @@ void RelAxisEventHandler::send(UInput& uinput, int value) {
     float v = m_value * m_stick_value;
 
     if (v == 0)
-      uinput.send_rel_repetitive(m_code, v, -1);
+      uinput.send_rel_repetitive(m_rel_repeat, v, -1);
     else
-      uinput.send_rel_repetitive(m_code, v, m_repeat);
-  }
-}
-
-void RelAxisEventHandler::update(UInput& uinput, int msec_delta) {
-  if (m_repeat == -1 && m_stick_value != 0.0f) {
-    // new and improved REL style event sending
-
-    float rel_value =
-        m_stick_value * m_value * static_cast<float>(msec_delta) / 1000.0f;
-
-    // keep track of the rest that we lose when converting to integer
-    rel_value += m_rest_value;
-    m_rest_value = rel_value - truncf(rel_value);
-
-    m_rel_emitter->send(static_cast<int>(rel_value));
+      uinput.send_rel_repetitive(m_rel_repeat, v, m_repeat);
+  } else {
+    // new and improved REL style event sending, m_value is the
+    // speed in events per second at full deflection
+    uinput.set_rel_velocity(m_rel_repeat, m_stick_value * m_value);
   }
 }
 
@@ -22,7 +22,7 @@
 #include <string>
 
 #include "axis_event.hpp"
-#include "ui_event_emitter.hpp"
+#include "ui_event.hpp"
 
 class RelAxisEventHandler : public AxisEventHandler {
  public:
@@ -35,7 +35,7 @@ class RelAxisEventHandler : public AxisEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, int value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta) {}
 
   std::string str() const;
 
@@ -45,9 +45,8 @@ class RelAxisEventHandler : public AxisEventHandler {
   int m_repeat;
 
   float m_stick_value;
-  float m_rest_value;
 
-  UIEventEmitterPtr m_rel_emitter;
+  int m_rel_repeat;
 };
 
 #endif
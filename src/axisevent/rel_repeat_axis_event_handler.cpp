@@ -18,8 +18,6 @@
 
 #include "axisevent/rel_repeat_axis_event_handler.hpp"
 
-#include <cassert>
-#include <cmath>
 #include <sstream>
 #include <stdexcept>
 
@@ -47,15 +45,13 @@ RelRepeatAxisEventHandler::RelRepeatAxisEventHandler(const UIEvent& code,
       m_value(value),
       m_repeat(repeat),
       m_stick_value(0),
-      m_timer(0),
-      m_rel_emitter() {}
+      m_rel_repeat(-1) {}
 
 void RelRepeatAxisEventHandler::init(UInput& uinput, int slot,
                                      bool extra_devices) {
-  assert(!m_rel_emitter);
-
   m_code.resolve_device_id(slot, extra_devices);
-  m_rel_emitter = uinput.add_rel(m_code.get_device_id(), m_code.code);
+  uinput.add_rel(m_code.get_device_id(), m_code.code);
+  m_rel_repeat = uinput.add_rel_repeat(m_code);
 }
 
 void RelRepeatAxisEventHandler::send(UInput& uinput, int value) {
@@ -65,25 +61,10 @@ void RelRepeatAxisEventHandler::send(UInput& uinput, int value) {
     m_stick_value = value / static_cast<float>(m_max);
   }
 
-  // reset timer when in center position
-  if (value == 0) {
-    m_timer = 0;
-  }
-}
-
-void RelRepeatAxisEventHandler::update(UInput& uinput, int msec_delta) {
-  // time ticks slower depending on how fr the stick is moved
-  m_timer += msec_delta * fabsf(m_stick_value);
-
-  while (m_timer > m_repeat) {
-    if (m_stick_value < 0) {
-      m_rel_emitter->send(-m_value);
-    } else {
-      m_rel_emitter->send(m_value);
-    }
-
-    m_timer -= m_repeat;
-  }
+  // m_value every m_repeat msec at full deflection, slower the less
+  // the stick is moved
+  uinput.set_rel_velocity(m_rel_repeat,
+                          m_stick_value * m_value * 1000.0f / m_repeat);
 }
 
 std::string RelRepeatAxisEventHandler::str() const {
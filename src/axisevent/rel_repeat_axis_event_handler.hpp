@@ -22,7 +22,7 @@
 #include <string>
 
 #include "axis_event.hpp"
-#include "ui_event_emitter.hpp"
+#include "ui_event.hpp"
 
 class RelRepeatAxisEventHandler : public AxisEventHandler {
  public:
@@ -33,7 +33,7 @@ class RelRepeatAxisEventHandler : public AxisEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, int value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta) {}
 
   std::string str() const;
 
@@ -43,9 +43,8 @@ class RelRepeatAxisEventHandler : public AxisEventHandler {
   float m_repeat;
 
   float m_stick_value;
-  int m_timer;
 
-  UIEventEmitterPtr m_rel_emitter;
+  int m_rel_repeat;
 };
 
 #endif
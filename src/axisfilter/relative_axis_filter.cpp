@@ -47,8 +47,9 @@ RelativeAxisFilter* RelativeAxisFilter::from_string(const std::string& str) {
 RelativeAxisFilter::RelativeAxisFilter(int speed)
     : m_speed(speed), m_float_speed(0.0f), m_value(0), m_state(0) {}
 
-void RelativeAxisFilter::update(int msec_delta) {
-  m_state += m_float_speed * m_value * msec_delta / 1000.0f;
+void RelativeAxisFilter::update(int64_t nsec_delta) {
+  m_state += m_float_speed * m_value *
+             static_cast<float>(static_cast<double>(nsec_delta) / 1e9);
   m_state = std::clamp(m_state, -1.0f, 1.0f);
 }
 
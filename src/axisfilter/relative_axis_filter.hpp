@@ -30,7 +30,8 @@ class RelativeAxisFilter : public AxisFilter {
  public:
   RelativeAxisFilter(int speed);
 
-  void update(int msec_delta);
+  void update(int64_t nsec_delta);
+  bool needs_update() const { return m_value != 0.0f; }
   int filter(int value, int min, int max);
   std::string str() const;
 
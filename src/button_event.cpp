@@ -146,17 +146,28 @@ void ButtonEvent::send(UInput& uinput, bool raw_state) {
   }
 }
 
-void ButtonEvent::update(UInput& uinput, int msec_delta) {
+void ButtonEvent::update(UInput& uinput, int64_t nsec_delta) {
   for (std::vector<ButtonFilterPtr>::const_iterator i = m_filters.begin();
        i != m_filters.end(); ++i) {
-    (*i)->update(msec_delta);
+    (*i)->update(nsec_delta);
   }
 
-  m_handler->update(uinput, msec_delta);
+  m_handler->update(uinput, nsec_delta);
 
   send(uinput, m_last_raw_state);
 }
 
+bool ButtonEvent::needs_update() const {
+  for (std::vector<ButtonFilterPtr>::const_iterator i = m_filters.begin();
+       i != m_filters.end(); ++i) {
+    if ((*i)->needs_update()) {
+      return true;
+    }
+  }
+
+  return m_handler->needs_update();
+}
+
 std::string ButtonEvent::str() const { return m_handler->str(); }
 
 /* EOF */
@@ -50,7 +50,8 @@ class ButtonEvent {
  public:
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, bool value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta);
+  bool needs_update() const;
   std::string str() const;
 
   void add_filters(const std::vector<ButtonFilterPtr>& filters);
@@ -69,7 +70,11 @@ class ButtonEventHandler {
 
   virtual void init(UInput& uinput, int slot, bool extra_devices) = 0;
   virtual void send(UInput& uinput, bool value) = 0;
-  virtual void update(UInput& uinput, int msec_delta) = 0;
+  virtual void update(UInput& uinput, int64_t nsec_delta) = 0;
+
+  /** Returns true while update() does something, so that it only has
+      to be called periodically while it does */
+  virtual bool needs_update() const { return false; }
   virtual std::string str() const = 0;
 };
 
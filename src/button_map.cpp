@@ -70,14 +70,25 @@ void ButtonMap::init(UInput& uinput, int slot, bool extra_devices) const {
   }
 }
 
-void ButtonMap::update(UInput& uinput, int msec_delta) {
+void ButtonMap::update(UInput& uinput, int64_t nsec_delta) {
   for (int shift_code = 0; shift_code < XBOX_BTN_MAX; ++shift_code) {
     for (int code = 0; code < XBOX_BTN_MAX; ++code) {
       if (btn_map[shift_code][code]) {
-        btn_map[shift_code][code]->update(uinput, msec_delta);
+        btn_map[shift_code][code]->update(uinput, nsec_delta);
       }
     }
   }
 }
 
+bool ButtonMap::needs_update() const {
+  for (int shift_code = 0; shift_code < XBOX_BTN_MAX; ++shift_code) {
+    for (int code = 0; code < XBOX_BTN_MAX; ++code) {
+      if (btn_map[shift_code][code] && btn_map[shift_code][code]->needs_update()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 /* EOF */
@@ -33,7 +33,7 @@ class AbsButtonEventHandler : public ButtonEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, bool value);
-  void update(UInput& uinput, int msec_delta) {}
+  void update(UInput& uinput, int64_t nsec_delta) {}
 
   std::string str() const;
 
@@ -147,7 +147,7 @@ void CycleKeyButtonEventHandler::send(UInput& uinput, bool value) {
   }
 }
 
-void CycleKeyButtonEventHandler::update(UInput& uinput, int msec_delta) {}
+void CycleKeyButtonEventHandler::update(UInput& uinput, int64_t nsec_delta) {}
 
 std::string CycleKeyButtonEventHandler::str() const { return "cycle-key"; }
 
@@ -18,23 +18,28 @@
 
 #include "exec_button_event_handler.hpp"
 
-#include <sys/wait.h>
-
-#include <cerrno>
-#include <cstring>
+#include <stdexcept>
 
 #include "helper.hpp"
 #include "log.hpp"
+#include "raise_exception.hpp"
 
 ExecButtonEventHandler* ExecButtonEventHandler::from_string(
     const std::string& str) {
   std::vector<std::string> args = string_split(str, ":");
-  return new ExecButtonEventHandler(args);
+  if (args.empty() || args[0].empty()) {
+    raise_exception(std::runtime_error, "exec requires a program: " << str);
+  } else {
+    return new ExecButtonEventHandler(args);
+  }
 }
 
 ExecButtonEventHandler::ExecButtonEventHandler(
     const std::vector<std::string>& args)
-    : m_args(args) {}
+    : m_args(args),
+      m_argv(make_argv(m_args)),
+      m_last_spawn(0),
+      m_running(new int(0)) {}
 
 void ExecButtonEventHandler::init(UInput& uinput, int slot,
                                   bool extra_devices) {
@@ -46,29 +51,20 @@ void ExecButtonEventHandler::send(UInput& uinput, bool value) {
     return;
   }
 
-  pid_t tmp_pid = fork();
-  if (tmp_pid == 0) {
-    // Double fork to reap the child and disown the execed process
-    pid_t pid = fork();
-
-    if (pid == 0) {
-      char** argv =
-          static_cast<char**>(malloc(sizeof(char*) * (m_args.size() + 1)));
-      for (size_t i = 0; i < m_args.size(); ++i) {
-        argv[i] = strdup(m_args[i].c_str());
-      }
-      argv[m_args.size()] = NULL;
-
-      if (execvp(m_args[0].c_str(), argv) == -1) {
-        log_error("exec failed: " << strerror(errno));
-        _exit(EXIT_FAILURE);
-      }
+  gint64 now = g_get_monotonic_time();
+  if (m_last_spawn && now - m_last_spawn < kMinIntervalMsec * 1000) {
+    log_debug("ignoring exec, last one was too recent");
+  } else if (*m_running >= kMaxRunning) {
+    log_debug("ignoring exec, " << *m_running << " still running");
+  } else {
+    std::shared_ptr<int> running = m_running;
+    if (spawn_detached(m_argv.data(), [running](int status) {
+          *running -= 1;
+        })) {
+      *m_running += 1;
+      m_last_spawn = now;
     }
-
-    _exit(EXIT_SUCCESS);
   }
-
-  waitpid(tmp_pid, NULL, 0);
 }
 
 std::string ExecButtonEventHandler::str() const { return "exec"; }
@@ -19,6 +19,9 @@
 #ifndef HEADER_XBOXDRV_BUTTONEVENT_EXEC_BUTTON_EVENT_HANDLER_HPP
 #define HEADER_XBOXDRV_BUTTONEVENT_EXEC_BUTTON_EVENT_HANDLER_HPP
 
+#include <glib.h>
+
+#include <memory>
 #include <string>
 
 #include "button_event.hpp"
@@ -32,12 +35,26 @@ class ExecButtonEventHandler : public ButtonEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, bool value);
-  void update(UInput& uinput, int msec_delta) {}
+  void update(UInput& uinput, int64_t nsec_delta) {}
 
   std::string str() const;
 
  private:
+  // protection against button mashing
+  static const int kMinIntervalMsec = 200;
+  static const int kMaxRunning = 4;
+
   std::vector<std::string> m_args;
+  std::vector<char*> m_argv;
+
+  gint64 m_last_spawn;
+
+  // shared with the child watches, which can outlive the handler
+  std::shared_ptr<int> m_running;
+
+ private:
+  ExecButtonEventHandler(const ExecButtonEventHandler&);
+  ExecButtonEventHandler& operator=(const ExecButtonEventHandler&);
 };
 
 #endif
@@ -92,7 +92,7 @@ void KeyButtonEventHandler::send(UInput& uinput, bool value) {
     if (m_hold_threshold == 0) {
       m_codes.send(uinput, m_state);
     } else {
-      if (m_hold_counter < m_hold_threshold) {
+      if (m_hold_counter < msec2nsec(m_hold_threshold)) {
         if (m_state) {
           // we are only sending events after release or when
           // hold_threshold is passed
@@ -116,17 +116,17 @@ void KeyButtonEventHandler::send(UInput& uinput, bool value) {
   }
 }
 
-void KeyButtonEventHandler::update(UInput& uinput, int msec_delta) {
+void KeyButtonEventHandler::update(UInput& uinput, int64_t nsec_delta) {
   if (m_state && m_hold_threshold) {
-    if (m_hold_counter < m_hold_threshold &&
-        m_hold_counter + msec_delta >= m_hold_threshold) {
+    if (m_hold_counter < msec2nsec(m_hold_threshold) &&
+        m_hold_counter + nsec_delta >= msec2nsec(m_hold_threshold)) {
       // start sending the secondary events
       m_secondary_codes.send(uinput, true);
       uinput.sync();
     }
 
-    if (m_hold_counter < m_hold_threshold) {
-      m_hold_counter += msec_delta;
+    if (m_hold_counter < msec2nsec(m_hold_threshold)) {
+      m_hold_counter += nsec_delta;
     }
   }
 }
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "button_event.hpp"
+#include "helper.hpp"
 #include "ui_event_sequence.hpp"
 
 class KeyButtonEventHandler : public ButtonEventHandler {
@@ -34,7 +35,10 @@ class KeyButtonEventHandler : public ButtonEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, bool value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta);
+  bool needs_update() const {
+    return m_state && m_hold_counter < msec2nsec(m_hold_threshold);
+  }
 
   std::string str() const;
 
@@ -42,8 +46,10 @@ class KeyButtonEventHandler : public ButtonEventHandler {
   bool m_state;
   UIEventSequence m_codes;
   UIEventSequence m_secondary_codes;
+  /** msec */
   int m_hold_threshold;
-  int m_hold_counter;
+  /** nsec the key has been held */
+  int64_t m_hold_counter;
 };
 
 #endif
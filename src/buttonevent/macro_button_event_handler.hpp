@@ -19,60 +19,35 @@
 #ifndef HEADER_XBOXDRV_BUTTONEVENT_MACRO_BUTTON_EVENT_HANDLER_HPP
 #define HEADER_XBOXDRV_BUTTONEVENT_MACRO_BUTTON_EVENT_HANDLER_HPP
 
+#include <memory>
 #include <string>
 
 #include "button_event.hpp"
+#include "macro_engine.hpp"
 
 class MacroButtonEventHandler : public ButtonEventHandler {
  public:
- private:
-  struct AbsInfo {
-    UIEvent event;
-    int minimum;
-    int maximum;
-    int fuzz;
-    int flat;
-  };
-
-  struct Event {
-    UIEvent event;
-    int value;
-  };
-
-  struct Time {
-    int msec;
-  };
-
-  struct MacroEvent {
-    enum { kInitOp, kSendOp, kWaitOp, kNull } type;
+  static MacroButtonEventHandler* from_string(const std::string& filename);
 
-    union {
-      AbsInfo init;
-      Event send;
-      Time wait;
-    };
-  };
+ private:
+  // how many instances of the macro can run at the same time
+  static const int kMaxInstances = 4;
 
- public:
-  static MacroButtonEventHandler* from_string(const std::string& filename);
+  std::unique_ptr<MacroProgram> m_program;
+  MacroEngine::Instance m_instances[kMaxInstances];
 
  public:
-  MacroButtonEventHandler(const std::vector<MacroEvent>& events);
+  MacroButtonEventHandler(std::unique_ptr<MacroProgram> program);
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, bool value);
-  void update(UInput& uinput, int msec_delta);
+  void update(UInput& uinput, int64_t nsec_delta) {}
 
   std::string str() const;
 
  private:
-  static MacroEvent macro_event_from_string(const std::string& str);
-
- private:
-  std::vector<MacroEvent> m_events;
-  bool m_send_in_progress;
-  int m_countdown;
-  std::vector<MacroEvent>::size_type m_event_counter;
+  MacroButtonEventHandler(const MacroButtonEventHandler&);
+  MacroButtonEventHandler& operator=(const MacroButtonEventHandler&);
 };
 
 #endif
@@ -51,11 +51,18 @@ RelButtonEventHandler* RelButtonEventHandler::from_string(
 }
 
 RelButtonEventHandler::RelButtonEventHandler(const UIEvent& code)
-    : m_code(code), m_value(3), m_repeat(100), m_rel_emitter() {}
+    : m_code(code),
+      m_value(3),
+      m_repeat(100),
+      m_rel_emitter(),
+      m_rel_repeat(-1) {}
 
 void RelButtonEventHandler::init(UInput& uinput, int slot, bool extra_devices) {
   m_code.resolve_device_id(slot, extra_devices);
   m_rel_emitter = uinput.add_rel(m_code.get_device_id(), m_code.code);
+  if (m_repeat != -1) {
+    m_rel_repeat = uinput.add_rel_repeat(m_code);
+  }
 }
 
 void RelButtonEventHandler::send(UInput& uinput, bool value) {
@@ -65,9 +72,9 @@ void RelButtonEventHandler::send(UInput& uinput, bool value) {
     }
   } else {
     if (value) {
-      uinput.send_rel_repetitive(m_code, m_value, m_repeat);
+      uinput.send_rel_repetitive(m_rel_repeat, m_value, m_repeat);
     } else {
-      uinput.send_rel_repetitive(m_code, m_value, -1);
+      uinput.send_rel_repetitive(m_rel_repeat, m_value, -1);
     }
   }
 }
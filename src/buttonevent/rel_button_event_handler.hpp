@@ -33,7 +33,7 @@ class RelButtonEventHandler : public ButtonEventHandler {
 
   void init(UInput& uinput, int slot, bool extra_devices);
   void send(UInput& uinput, bool value);
-  void update(UInput& uinput, int msec_delta) {}
+  void update(UInput& uinput, int64_t nsec_delta) {}
 
   std::string str() const;
 
@@ -44,6 +44,7 @@ class RelButtonEventHandler : public ButtonEventHandler {
   int m_repeat;
 
   UIEventEmitterPtr m_rel_emitter;
+  int m_rel_repeat;
 };
 
 #endif
@@ -55,11 +55,11 @@ AutofireButtonFilter::AutofireButtonFilter(int rate, int delay)
       m_delay(delay),
       m_counter(0) {}
 
-void AutofireButtonFilter::update(int msec_delta) {
+void AutofireButtonFilter::update(int64_t nsec_delta) {
   if (m_state) {
-    m_counter += msec_delta;
+    m_counter += nsec_delta;
 
-    if (m_counter > m_delay) {
+    if (m_counter > msec2nsec(m_delay)) {
       m_autofire = true;
     }
   }
@@ -74,7 +74,7 @@ bool AutofireButtonFilter::filter(bool value) {
     return false;
   } else {  // auto fire
     if (m_autofire) {
-      if (m_counter > m_rate) {
+      if (m_counter > msec2nsec(m_rate)) {
         m_counter = 0;
         return true;
       } else {
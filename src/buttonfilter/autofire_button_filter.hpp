@@ -30,7 +30,8 @@ class AutofireButtonFilter : public ButtonFilter {
  public:
   AutofireButtonFilter(int rate, int delay);
 
-  void update(int msec_delta);
+  void update(int64_t nsec_delta);
+  bool needs_update() const { return m_state; }
   bool filter(bool value);
   std::string str() const;
 
@@ -41,7 +42,8 @@ class AutofireButtonFilter : public ButtonFilter {
   /** msec between shots */
   int m_rate;
   int m_delay;
-  int m_counter;
+  /** nsec since the last shot */
+  int64_t m_counter;
 };
 
 #endif
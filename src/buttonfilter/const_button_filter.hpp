@@ -30,7 +30,7 @@ class ConstButtonFilter : public ButtonFilter {
  public:
   ConstButtonFilter(bool value);
 
-  void update(int msec_delta) {}
+  void update(int64_t nsec_delta) {}
   bool filter(bool value);
   std::string str() const;
 
@@ -27,11 +27,13 @@ DelayButtonFilter* DelayButtonFilter::from_string(const std::string& str) {
   return new DelayButtonFilter(std::stoi(str));
 }
 
-DelayButtonFilter::DelayButtonFilter(int delay) : m_delay(delay), m_time(0) {}
+DelayButtonFilter::DelayButtonFilter(int delay)
+    : m_delay(delay), m_time(0), m_pressed(false) {}
 
 bool DelayButtonFilter::filter(bool value) {
+  m_pressed = value;
   if (value) {
-    if (m_time < m_delay) {
+    if (m_time < msec2nsec(m_delay)) {
       return false;
     } else {
       return true;
@@ -42,7 +44,12 @@ bool DelayButtonFilter::filter(bool value) {
   }
 }
 
-void DelayButtonFilter::update(int msec_delta) { m_time += msec_delta; }
+void DelayButtonFilter::update(int64_t nsec_delta) {
+  // only count the time the button is held
+  if (m_pressed) {
+    m_time += nsec_delta;
+  }
+}
 
 std::string DelayButtonFilter::str() const {
   std::ostringstream os;
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "button_filter.hpp"
+#include "helper.hpp"
 
 class DelayButtonFilter : public ButtonFilter {
  public:
@@ -32,13 +33,16 @@ class DelayButtonFilter : public ButtonFilter {
   DelayButtonFilter(int delay);
 
   bool filter(bool value);
-  void update(int msec_delta);
+  void update(int64_t nsec_delta);
+  bool needs_update() const { return m_pressed && m_time < msec2nsec(m_delay); }
 
   std::string str() const;
 
  private:
   int m_delay;
-  int m_time;
+  /** nsec the button has been held */
+  int64_t m_time;
+  bool m_pressed;
 };
 
 #endif
@@ -27,7 +27,7 @@ class InvertButtonFilter : public ButtonFilter {
  public:
   InvertButtonFilter() {}
 
-  void update(int msec_delta) {}
+  void update(int64_t nsec_delta) {}
   bool filter(bool value);
   std::string str() const;
 };
@@ -28,7 +28,7 @@ class ToggleButtonFilter : public ButtonFilter {
   ToggleButtonFilter();
 
   bool filter(bool value);
-  void update(int msec_delta) {}
+  void update(int64_t nsec_delta) {}
   std::string str() const;
 
  private:
@@ -18,24 +18,89 @@
 
 #include "chatpad.hpp"
 
+#include <linux/input.h>
+
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <stdexcept>
 
 #include "helper.hpp"
-#include "linux_uinput.hpp"
-#include "raise_exception.hpp"
-#include "usb_helper.hpp"
-
-struct USBControlMsg {
-  uint8_t bmRequestType;
-  uint8_t bRequest;
-  uint16_t wValue;
-  uint16_t wIndex;
-  unsigned char* data;
-  uint16_t wLength;
-};
+#include "log.hpp"
+#include "usb_controller.hpp"
+
+using std::placeholders::_1;
+using std::placeholders::_2;
+
+namespace {
+
+constexpr std::array<int, 256> make_chatpad_keymap() {
+  std::array<int, 256> keymap{};
+
+  keymap[CHATPAD_KEY_1] = KEY_1;
+  keymap[CHATPAD_KEY_2] = KEY_2;
+  keymap[CHATPAD_KEY_3] = KEY_3;
+  keymap[CHATPAD_KEY_4] = KEY_4;
+  keymap[CHATPAD_KEY_5] = KEY_5;
+  keymap[CHATPAD_KEY_6] = KEY_6;
+  keymap[CHATPAD_KEY_7] = KEY_7;
+  keymap[CHATPAD_KEY_8] = KEY_8;
+  keymap[CHATPAD_KEY_9] = KEY_9;
+  keymap[CHATPAD_KEY_0] = KEY_0;
+  keymap[CHATPAD_KEY_Q] = KEY_Q;
+  keymap[CHATPAD_KEY_W] = KEY_W;
+  keymap[CHATPAD_KEY_E] = KEY_E;
+  keymap[CHATPAD_KEY_R] = KEY_R;
+  keymap[CHATPAD_KEY_T] = KEY_T;
+  keymap[CHATPAD_KEY_Y] = KEY_Y;
+  keymap[CHATPAD_KEY_U] = KEY_U;
+  keymap[CHATPAD_KEY_I] = KEY_I;
+  keymap[CHATPAD_KEY_O] = KEY_O;
+  keymap[CHATPAD_KEY_P] = KEY_P;
+  keymap[CHATPAD_KEY_A] = KEY_A;
+  keymap[CHATPAD_KEY_S] = KEY_S;
+  keymap[CHATPAD_KEY_D] = KEY_D;
+  keymap[CHATPAD_KEY_F] = KEY_F;
+  keymap[CHATPAD_KEY_G] = KEY_G;
+  keymap[CHATPAD_KEY_H] = KEY_H;
+  keymap[CHATPAD_KEY_J] = KEY_J;
+  keymap[CHATPAD_KEY_K] = KEY_K;
+  keymap[CHATPAD_KEY_L] = KEY_L;
+  keymap[CHATPAD_KEY_COMMA] = KEY_COMMA;
+  keymap[CHATPAD_KEY_Z] = KEY_Z;
+  keymap[CHATPAD_KEY_X] = KEY_X;
+  keymap[CHATPAD_KEY_C] = KEY_C;
+  keymap[CHATPAD_KEY_V] = KEY_V;
+  keymap[CHATPAD_KEY_B] = KEY_B;
+  keymap[CHATPAD_KEY_N] = KEY_N;
+  keymap[CHATPAD_KEY_M] = KEY_M;
+  keymap[CHATPAD_KEY_PERIOD] = KEY_DOT;
+  keymap[CHATPAD_KEY_ENTER] = KEY_ENTER;
+  keymap[CHATPAD_KEY_BACKSPACE] = KEY_BACKSPACE;
+  keymap[CHATPAD_KEY_LEFT] = KEY_LEFT;
+  keymap[CHATPAD_KEY_SPACEBAR] = KEY_SPACE;
+  keymap[CHATPAD_KEY_RIGHT] = KEY_RIGHT;
+
+  keymap[CHATPAD_MOD_SHIFT] = KEY_LEFTSHIFT;
+  keymap[CHATPAD_MOD_GREEN] = KEY_LEFTALT;
+  keymap[CHATPAD_MOD_ORANGE] = KEY_LEFTCTRL;
+  keymap[CHATPAD_MOD_PEOPLE] = KEY_LEFTMETA;
+
+  return keymap;
+}
+
+constexpr std::array<int, 256> chatpad_keymap = make_chatpad_keymap();
+
+const uint8_t chatpad_modifiers[] = {CHATPAD_MOD_SHIFT, CHATPAD_MOD_GREEN,
+                                     CHATPAD_MOD_ORANGE, CHATPAD_MOD_PEOPLE};
+
+bool contains(const uint8_t* keys, int num_keys, uint8_t key) {
+  return std::find(keys, keys + num_keys, key) != keys + num_keys;
+}
+
+}  // namespace
 
 /*
   Chatpad Interface:
@@ -45,76 +110,36 @@ struct USBControlMsg {
   bInterfaceSubClass     93
   bInterfaceProtocol      2
 */
-Chatpad::Chatpad(libusb_device_handle* handle, uint16_t bcdDevice, bool no_init,
+std::vector<int> Chatpad::get_keys() {
+  std::vector<int> keys;
+  for (int i = 0; i < 256; ++i) {
+    if (chatpad_keymap[i]) {
+      keys.push_back(chatpad_keymap[i]);
+    }
+  }
+  return keys;
+}
+
+Chatpad::Chatpad(USBController& controller, uint16_t bcdDevice, bool no_init,
                  bool debug)
     : m_init_state(kStateInit1),
-      m_handle(handle),
+      m_controller(controller),
       m_bcdDevice(bcdDevice),
       m_no_init(no_init),
       m_debug(debug),
-      m_quit_thread(false),
-      m_uinput(),
+      m_pressed(),
+      m_num_pressed(0),
+      m_keys(),
       m_led_state(0),
-      m_read_transfer(0) {
+      m_timeout_id(0) {
   if (m_bcdDevice != 0x0110 && m_bcdDevice != 0x0114) {
     throw std::runtime_error(
         "unknown bcdDevice version number, please report this issue "
         "to <grumbel@gmail.com> and include the output of 'lsusb -v'");
   }
 
-  std::fill_n(m_keymap, 256, 0);
-  std::fill_n(m_state, 256, 0);
-
-  m_keymap[CHATPAD_KEY_1] = KEY_1;
-  m_keymap[CHATPAD_KEY_2] = KEY_2;
-  m_keymap[CHATPAD_KEY_3] = KEY_3;
-  m_keymap[CHATPAD_KEY_4] = KEY_4;
-  m_keymap[CHATPAD_KEY_5] = KEY_5;
-  m_keymap[CHATPAD_KEY_6] = KEY_6;
-  m_keymap[CHATPAD_KEY_7] = KEY_7;
-  m_keymap[CHATPAD_KEY_8] = KEY_8;
-  m_keymap[CHATPAD_KEY_9] = KEY_9;
-  m_keymap[CHATPAD_KEY_0] = KEY_0;
-  m_keymap[CHATPAD_KEY_Q] = KEY_Q;
-  m_keymap[CHATPAD_KEY_W] = KEY_W;
-  m_keymap[CHATPAD_KEY_E] = KEY_E;
-  m_keymap[CHATPAD_KEY_R] = KEY_R;
-  m_keymap[CHATPAD_KEY_T] = KEY_T;
-  m_keymap[CHATPAD_KEY_Y] = KEY_Y;
-  m_keymap[CHATPAD_KEY_U] = KEY_U;
-  m_keymap[CHATPAD_KEY_I] = KEY_I;
-  m_keymap[CHATPAD_KEY_O] = KEY_O;
-  m_keymap[CHATPAD_KEY_P] = KEY_P;
-  m_keymap[CHATPAD_KEY_A] = KEY_A;
-  m_keymap[CHATPAD_KEY_S] = KEY_S;
-  m_keymap[CHATPAD_KEY_D] = KEY_D;
-  m_keymap[CHATPAD_KEY_F] = KEY_F;
-  m_keymap[CHATPAD_KEY_G] = KEY_G;
-  m_keymap[CHATPAD_KEY_H] = KEY_H;
-  m_keymap[CHATPAD_KEY_J] = KEY_J;
-  m_keymap[CHATPAD_KEY_K] = KEY_K;
-  m_keymap[CHATPAD_KEY_L] = KEY_L;
-  m_keymap[CHATPAD_KEY_COMMA] = KEY_COMMA;
-  m_keymap[CHATPAD_KEY_Z] = KEY_Z;
-  m_keymap[CHATPAD_KEY_X] = KEY_X;
-  m_keymap[CHATPAD_KEY_C] = KEY_C;
-  m_keymap[CHATPAD_KEY_V] = KEY_V;
-  m_keymap[CHATPAD_KEY_B] = KEY_B;
-  m_keymap[CHATPAD_KEY_N] = KEY_N;
-  m_keymap[CHATPAD_KEY_M] = KEY_M;
-  m_keymap[CHATPAD_KEY_PERIOD] = KEY_DOT;
-  m_keymap[CHATPAD_KEY_ENTER] = KEY_ENTER;
-  m_keymap[CHATPAD_KEY_BACKSPACE] = KEY_BACKSPACE;
-  m_keymap[CHATPAD_KEY_LEFT] = KEY_LEFT;
-  m_keymap[CHATPAD_KEY_SPACEBAR] = KEY_SPACE;
-  m_keymap[CHATPAD_KEY_RIGHT] = KEY_RIGHT;
-
-  m_keymap[CHATPAD_MOD_SHIFT] = KEY_LEFTSHIFT;
-  m_keymap[CHATPAD_MOD_GREEN] = KEY_LEFTALT;
-  m_keymap[CHATPAD_MOD_ORANGE] = KEY_LEFTCTRL;
-  m_keymap[CHATPAD_MOD_PEOPLE] = KEY_LEFTMETA;
-
-  init_uinput();
+  // a report can release and press all six keys
+  m_keys.reserve(2 * sizeof(m_pressed));
 
   if (no_init) {
     m_init_state = kStateKeepAlive_1e;
@@ -122,89 +147,34 @@ Chatpad::Chatpad(libusb_device_handle* handle, uint16_t bcdDevice, bool no_init,
 
   send_command();
 
+  USBController::ReadCallback callback =
+      std::bind(&Chatpad::on_read_data, this, _1, _2);
   if (m_bcdDevice == 0x0110) {
-    usb_submit_read(6, 32);
+    m_controller.usb_submit_read(6, 32, callback);
   } else if (m_bcdDevice == 0x0114) {
-    usb_submit_read(4, 32);
+    m_controller.usb_submit_read(4, 32, callback);
   }
 }
 
 Chatpad::~Chatpad() {
-  if (m_read_transfer) {
-    libusb_cancel_transfer(m_read_transfer);
-    libusb_free_transfer(m_read_transfer);
-  }
-}
-
-void Chatpad::init_uinput() {
-  struct input_id usbid;
-
-  usbid.bustype = 0;
-  usbid.vendor = 0;
-  usbid.product = 0;
-  usbid.version = 0;
-
-  m_uinput.reset(
-      new LinuxUinput(LinuxUinput::kGenericDevice, "Xbox360 Chatpad", usbid));
-
-  for (int i = 0; i < 256; ++i) {
-    if (m_keymap[i]) {
-      m_uinput->add_key(m_keymap[i]);
-    }
+  if (m_timeout_id) {
+    g_source_remove(m_timeout_id);
   }
-  m_uinput->finish();
 }
 
-void Chatpad::usb_submit_read(int endpoint, int len) {
-  assert(!m_read_transfer);
-
-  m_read_transfer = libusb_alloc_transfer(0);
-
-  uint8_t* data = static_cast<uint8_t*>(malloc(sizeof(uint8_t) * len));
-  m_read_transfer->flags |= LIBUSB_TRANSFER_FREE_BUFFER;
-  libusb_fill_interrupt_transfer(m_read_transfer, m_handle,
-                                 endpoint | LIBUSB_ENDPOINT_IN, data, len,
-                                 &Chatpad::on_read_data_wrap, this,
-                                 0);  // timeout
-  int ret;
-  ret = libusb_submit_transfer(m_read_transfer);
-  if (ret != LIBUSB_SUCCESS) {
-    raise_exception(std::runtime_error,
-                    "libusb_submit_transfer(): " << usb_strerror(ret));
-  }
-}
-
-void Chatpad::on_read_data(libusb_transfer* transfer) {
-  assert(transfer);
-
-  if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
-    log_error(
-        "usb transfer failed: " << usb_transfer_strerror(transfer->status));
-  } else {
-    // log_tmp("chatpad data: " << usb_transfer_strerror(transfer->status) << "
-    // "
-    //         << raw2str(transfer->buffer, transfer->actual_length));
-
-    if (transfer->actual_length == 5 && transfer->buffer[0] == 0x00) {
-      struct ChatpadKeyMsg msg;
-      memcpy(&msg, transfer->buffer, transfer->actual_length);
-      process(msg);
-    }
+void Chatpad::on_read_data(uint8_t* data, int len) {
+  // log_tmp("chatpad data: " << raw2str(data, len));
 
-    int ret;
-    ret = libusb_submit_transfer(transfer);
-    if (ret != LIBUSB_SUCCESS) {
-      log_error("failed to resubmit USB transfer: " << usb_strerror(ret));
-      libusb_free_transfer(transfer);
-    }
+  if (len == 5 && data[0] == 0x00) {
+    struct ChatpadKeyMsg msg;
+    memcpy(&msg, data, len);
+    process(msg);
   }
 }
 
 void Chatpad::send_timeout(int msec) {
-  // FIMXE: must keep track of sources and destroy them in ~Chatpad()
-  // assert(m_timeout_id == -1);
-  // m_timeout_id =
-  g_timeout_add(1000, &Chatpad::on_timeout_wrap, this);
+  assert(m_timeout_id == 0);
+  m_timeout_id = g_timeout_add(msec, &Chatpad::on_timeout_wrap, this);
 }
 
 void Chatpad::send_command() {
@@ -220,33 +190,27 @@ void Chatpad::send_command() {
 
   switch (m_init_state) {
     case kStateInit1:
-      send_ctrl(0x40, 0xa9, 0xa30c, 0x4423, NULL, 0, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x40, 0xa9, 0xa30c, 0x4423, NULL, 0, true);
       break;
 
     case kStateInit2:
-      send_ctrl(0x40, 0xa9, 0x2344, 0x7f03, NULL, 0, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x40, 0xa9, 0x2344, 0x7f03, NULL, 0, true);
       break;
 
     case kStateInit3:
-      send_ctrl(0x40, 0xa9, 0x5839, 0x6832, NULL, 0, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x40, 0xa9, 0x5839, 0x6832, NULL, 0, true);
       break;
 
     case kStateInit4:
-      send_ctrl(0xc0, 0xa1, 0x0000, 0xe416, code, 2, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0xc0, 0xa1, 0x0000, 0xe416, code, 2, true);
       break;
 
     case kStateInit5:
-      send_ctrl(0x40, 0xa1, 0x0000, 0xe416, code, 2, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x40, 0xa1, 0x0000, 0xe416, code, 2, true);
       break;
 
     case kStateInit6:
-      send_ctrl(0xc0, 0xa1, 0x0000, 0xe416, code, 2, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0xc0, 0xa1, 0x0000, 0xe416, code, 2, true);
       break;
 
     case kStateInit_1e:
@@ -258,8 +222,7 @@ void Chatpad::send_command() {
       break;
 
     case kStateInit_1b:
-      send_ctrl(0x41, 0x0, 0x1b, 0x02, NULL, 0, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x41, 0x0, 0x1b, 0x02, NULL, 0, true);
       break;
 
     case kStateKeepAlive_1e:
@@ -276,14 +239,13 @@ void Chatpad::send_command() {
   }
 }
 
-void Chatpad::on_control(libusb_transfer* transfer) {
-  // log_tmp(m_init_state << " " << usb_transfer_strerror(transfer->status) << "
-  // len: " << transfer->actual_length);
-  if (transfer->actual_length != 0) {
-    // log_tmp(" PAYLOAD: " << raw2str(transfer->buffer,
-    // transfer->actual_length));
+void Chatpad::on_control(libusb_transfer_status status) {
+  if (status == LIBUSB_TRANSFER_CANCELLED) {
+    return;
   }
 
+  // log_tmp(m_init_state << " " << usb_transfer_strerror(status));
+
   switch (m_init_state) {
     case kStateInit1:
     case kStateInit2:
@@ -301,7 +263,7 @@ void Chatpad::on_control(libusb_transfer* transfer) {
     case kStateInit_1b:
     case kStateKeepAlive_1e:
     case kStateKeepAlive_1f:
-      if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
+      if (status != LIBUSB_TRANSFER_COMPLETED) {
         log_error("stuff went wrong");
       } else {
         m_init_state = static_cast<State>(m_init_state + 1);
@@ -319,45 +281,33 @@ void Chatpad::on_control(libusb_transfer* transfer) {
 }
 
 bool Chatpad::on_timeout() {
-  // m_timeout_id = -1;
+  m_timeout_id = 0;
   switch (m_init_state) {
     case kStateInit_1e:
     case kStateKeepAlive_1e:
-      send_ctrl(0x41, 0x0, 0x1f, 0x02, NULL, 0, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x41, 0x0, 0x1f, 0x02, NULL, 0, true);
       return false;
 
     case kStateInit_1f:
     case kStateKeepAlive_1f:
-      send_ctrl(0x41, 0x0, 0x1e, 0x02, NULL, 0, &Chatpad::on_control_wrap,
-                this);
+      send_ctrl(0x41, 0x0, 0x1e, 0x02, NULL, 0, true);
       return false;
 
     default:
       assert(!"invalid state");
-      break;
+      return false;
   }
 }
 
 void Chatpad::send_ctrl(uint8_t request_type, uint8_t request, uint16_t value,
                         uint16_t index, uint8_t* data_in, uint16_t length,
-                        libusb_transfer_cb_fn callback, void* userdata) {
-  libusb_transfer* transfer = libusb_alloc_transfer(0);
-  transfer->flags |= LIBUSB_TRANSFER_FREE_BUFFER;
-  transfer->flags |= LIBUSB_TRANSFER_FREE_TRANSFER;
-
-  // create and fill control buffer
-  uint8_t* data = static_cast<uint8_t*>(malloc(length + 8));
-  libusb_fill_control_setup(data, request_type, request, value, index, length);
-  memcpy(data + 8, data_in, length);
-  libusb_fill_control_transfer(transfer, m_handle, data, callback, userdata, 0);
-
-  int ret;
-  ret = libusb_submit_transfer(transfer);
-  if (ret != LIBUSB_SUCCESS) {
-    raise_exception(std::runtime_error,
-                    "libusb_submit_transfer(): " << usb_strerror(ret));
+                        bool advance) {
+  USBController::ControlCallback callback;
+  if (advance) {
+    callback = std::bind(&Chatpad::on_control, this, _1);
   }
+  m_controller.usb_control(request_type, request, value, index, data_in,
+                           length, callback);
 }
 
 bool Chatpad::get_led(unsigned int led) { return m_led_state & led; }
@@ -395,40 +345,55 @@ void Chatpad::set_led(unsigned int led, bool state) {
 }
 
 void Chatpad::process(const ChatpadKeyMsg& msg) {
-  // save old state
-  bool old_state[256];
-  memcpy(old_state, m_state, 256);
+  // collect the keys held down in this message
+  uint8_t pressed[6];
+  int num_pressed = 0;
 
-  // generate new state
-  std::fill_n(m_state, 256, 0);
+  for (uint8_t mod : chatpad_modifiers) {
+    if (msg.modifier & mod) {
+      pressed[num_pressed++] = mod;
+    }
+  }
 
-  m_state[CHATPAD_MOD_PEOPLE] = msg.modifier & CHATPAD_MOD_PEOPLE;
-  m_state[CHATPAD_MOD_ORANGE] = msg.modifier & CHATPAD_MOD_ORANGE;
-  m_state[CHATPAD_MOD_GREEN] = msg.modifier & CHATPAD_MOD_GREEN;
-  m_state[CHATPAD_MOD_SHIFT] = msg.modifier & CHATPAD_MOD_SHIFT;
+  if (msg.scancode1) pressed[num_pressed++] = msg.scancode1;
+  if (msg.scancode2 && msg.scancode2 != msg.scancode1) {
+    pressed[num_pressed++] = msg.scancode2;
+  }
 
-  if (msg.scancode1) m_state[msg.scancode1] = true;
-  if (msg.scancode2) m_state[msg.scancode2] = true;
+  // release keys that are no longer held
+  for (int i = 0; i < m_num_pressed; ++i) {
+    if (!contains(pressed, num_pressed, m_pressed[i])) {
+      ControllerKey released = {chatpad_keymap[m_pressed[i]], false};
+      m_keys.push_back(released);
+    }
+  }
 
-  // check for changes
-  for (int i = 0; i < 256; ++i) {
-    if (m_state[i] != old_state[i]) {
-      if (m_state[i]) {
-        if (i == CHATPAD_MOD_PEOPLE) {
-          set_led(CHATPAD_LED_PEOPLE, !get_led(CHATPAD_LED_PEOPLE));
-        } else if (i == CHATPAD_MOD_ORANGE) {
-          set_led(CHATPAD_LED_ORANGE, !get_led(CHATPAD_LED_ORANGE));
-        } else if (i == CHATPAD_MOD_GREEN) {
-          set_led(CHATPAD_LED_GREEN, !get_led(CHATPAD_LED_GREEN));
-        } else if (i == CHATPAD_MOD_SHIFT) {
-          set_led(CHATPAD_LED_SHIFT, !get_led(CHATPAD_LED_SHIFT));
-        }
+  // press new keys
+  for (int i = 0; i < num_pressed; ++i) {
+    uint8_t key = pressed[i];
+    if (!contains(m_pressed, m_num_pressed, key)) {
+      if (key == CHATPAD_MOD_PEOPLE) {
+        set_led(CHATPAD_LED_PEOPLE, !get_led(CHATPAD_LED_PEOPLE));
+      } else if (key == CHATPAD_MOD_ORANGE) {
+        set_led(CHATPAD_LED_ORANGE, !get_led(CHATPAD_LED_ORANGE));
+      } else if (key == CHATPAD_MOD_GREEN) {
+        set_led(CHATPAD_LED_GREEN, !get_led(CHATPAD_LED_GREEN));
+      } else if (key == CHATPAD_MOD_SHIFT) {
+        set_led(CHATPAD_LED_SHIFT, !get_led(CHATPAD_LED_SHIFT));
       }
 
-      m_uinput->send(EV_KEY, m_keymap[i], m_state[i]);
+      ControllerKey pressed_key = {chatpad_keymap[key], true};
+      m_keys.push_back(pressed_key);
     }
   }
-  m_uinput->sync();
+
+  std::copy(pressed, pressed + num_pressed, m_pressed);
+  m_num_pressed = num_pressed;
+
+  if (!m_keys.empty()) {
+    m_controller.submit_keys(m_keys);
+    m_keys.clear();
+  }
 }
 
 /* EOF */
@@ -26,9 +26,10 @@
 #include <string>
 #include <vector>
 
+#include "controller.hpp"
 #include "helper.hpp"
 
-class LinuxUinput;
+class USBController;
 
 enum {
   CHATPAD_KEY_1 = 0x17,
@@ -149,22 +150,29 @@ class Chatpad {
   } __attribute__((__packed__));
 
  private:
-  libusb_device_handle* m_handle;
+  /** the transfers go through the controller, which cancels them
+      when it is destroyed, so the Chatpad must not outlive it */
+  USBController& m_controller;
   uint16_t m_bcdDevice;
   bool m_no_init;
   bool m_debug;
 
-  bool m_quit_thread;
-  // std::shared_ptr<boost::thread> m_read_thread;
-  // std::shared_ptr<boost::thread> m_keep_alive_thread;
-  std::shared_ptr<LinuxUinput> m_uinput;
-  int m_keymap[256];
-  bool m_state[256];
+  /** keys currently held down, as scancodes or CHATPAD_MOD_* */
+  uint8_t m_pressed[6];
+  int m_num_pressed;
+
+  /** the key changes of the current report, passed to the controller
+      in one go */
+  std::vector<ControllerKey> m_keys;
+
   unsigned int m_led_state;
-  libusb_transfer* m_read_transfer;
+  guint m_timeout_id;
 
  public:
-  Chatpad(libusb_device_handle* handle, uint16_t bcdDevice, bool no_init,
+  /** The KEY_* codes the chatpad can send */
+  static std::vector<int> get_keys();
+
+  Chatpad(USBController& controller, uint16_t bcdDevice, bool no_init,
           bool debug);
   ~Chatpad();
 
@@ -174,16 +182,15 @@ class Chatpad {
   bool get_led(unsigned int led);
 
   void process(const ChatpadKeyMsg& msg);
-  void init_uinput();
 
  private:
   void send_command();
   void send_timeout(int msec);
+  /** with \a advance, the init and keep-alive state machine
+      continues in on_control() once the request finished */
   void send_ctrl(uint8_t request_type, uint8_t request, uint16_t value,
                  uint16_t index, uint8_t* data_in = NULL, uint16_t length = 0,
-                 libusb_transfer_cb_fn callback = NULL, void* userdata = NULL);
-
-  void usb_submit_read(int endpoint, int len);
+                 bool advance = false);
 
  private:
   bool on_timeout();
@@ -191,15 +198,8 @@ class Chatpad {
     return static_cast<Chatpad*>(data)->on_timeout();
   }
 
-  void on_control(libusb_transfer* transfer);
-  static void on_control_wrap(libusb_transfer* transfer) {
-    static_cast<Chatpad*>(transfer->user_data)->on_control(transfer);
-  }
-
-  void on_read_data(libusb_transfer* transfer);
-  static void on_read_data_wrap(libusb_transfer* transfer) {
-    static_cast<Chatpad*>(transfer->user_data)->on_read_data(transfer);
-  }
+  void on_control(libusb_transfer_status status);
+  void on_read_data(uint8_t* data, int len);
 
  private:
   Chatpad(const Chatpad&);
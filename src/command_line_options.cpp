@@ -18,7 +18,10 @@
 
 #include "command_line_options.hpp"
 
+#include <unistd.h>
+
 #include <cassert>
+#include <climits>
 #include <format>
 #include <fstream>
 #include <functional>
@@ -49,6 +52,8 @@ enum {
   OPTION_DEBUG,
   OPTION_QUIET,
   OPTION_SILENT,
+  OPTION_MONITOR,
+  OPTION_EXPORT_STATE,
   OPTION_USB_DEBUG,
   OPTION_DAEMON,
   OPTION_CONFIG_OPTION,
@@ -59,12 +64,17 @@ enum {
   OPTION_RUMBLE,
   OPTION_FF_DEVICE,
   OPTION_PRIORITY,
+  OPTION_MLOCK,
+  OPTION_CPU_AFFINITY,
   OPTION_QUIT,
   OPTION_NO_UINPUT,
+  OPTION_UINPUT_SOCKET,
   OPTION_MIMIC_XPAD,
   OPTION_MIMIC_XPAD_WIRELESS,
   OPTION_NO_EXTRA_DEVICES,
   OPTION_NO_EXTRA_EVENTS,
+  OPTION_REL_RATE,
+  OPTION_WHEEL_HI_RES,
   OPTION_TYPE,
   OPTION_FORCE_FEEDBACK,
   OPTION_RUMBLE_GAIN,
@@ -117,6 +127,7 @@ enum {
   OPTION_CHATPAD_NO_INIT,
   OPTION_CHATPAD_DEBUG,
   OPTION_TIMEOUT,
+  OPTION_DECIMATION,
   OPTION_HEADSET,
   OPTION_HEADSET_DUMP,
   OPTION_HEADSET_PLAY,
@@ -158,11 +169,23 @@ void CommandLineParser::init_argp() {
                   "be even more verbose then --verbose")
       .add_option(OPTION_SILENT, 's', "silent", "",
                   "do not display events on console")
+      .add_option(OPTION_MONITOR, 0, "monitor", "FILE",
+                  "write events as binary records to FILE for "
+                  "xboxdrv-monitor instead of the console")
+      .add_option(OPTION_EXPORT_STATE, 0, "export-state", "PREFIX",
+                  "publish the state of each slot in shared memory files "
+                  "PREFIX0, PREFIX1, ...")
       .add_option(OPTION_QUIET, 0, "quiet", "", "do not display startup text")
       .add_option(OPTION_USB_DEBUG, 0, "usb-debug", "",
                   "enable log messages from libusb")
       .add_option(OPTION_PRIORITY, 0, "priority", "PRI",
-                  "increases process priority (default: normal)")
+                  "normal, realtime, rr[:N] or fifo[:N] (default: normal)")
+      .add_option(OPTION_MLOCK, 0, "mlock", "",
+                  "lock all memory to avoid page faults while processing "
+                  "input")
+      .add_option(OPTION_CPU_AFFINITY, 0, "cpu-affinity", "CPUS",
+                  "run input processing on CPUS (e.g. 2 or 2-3), other "
+                  "threads on the remaining ones")
       .add_newline()
 
       .add_text("List Options: ")
@@ -324,6 +347,9 @@ void CommandLineParser::init_argp() {
       .add_option(OPTION_TIMEOUT, 0, "timeout", "INT",
                   "Amount of time to wait fo a device event before processing "
                   "autofire, etc. (default: 25)")
+      .add_option(OPTION_DECIMATION, 0, "decimation", "MSEC",
+                  "Merge controller reports arriving within MSEC into one "
+                  "frame, button changes are never dropped (default: 0)")
       .add_option(
           OPTION_BUTTONMAP, 'b', "buttonmap", "MAP",
           "Remap the buttons as specified by MAP (example: B=A,X=A,Y=A)")
@@ -380,12 +406,21 @@ void CommandLineParser::init_argp() {
       .add_text("Uinput Configuration Options: ")
       .add_option(OPTION_NO_UINPUT, 0, "no-uinput", "",
                   "do not try to start uinput event dispatching")
+      .add_option(OPTION_UINPUT_SOCKET, 0, "uinput-socket", "PATH",
+                  "send the uinput events to the SOCK_SEQPACKET socket at "
+                  "PATH instead of /dev/uinput")
       .add_option(OPTION_NO_EXTRA_DEVICES, 0, "no-extra-devices", "",
                   "Do not create separate virtual keyboard and mouse devices, "
                   "just use a single virtual device")
       .add_option(
           OPTION_NO_EXTRA_EVENTS, 0, "no-extra-events", "",
           "Do not create dummy events to facilitate device type detection")
+      .add_option(OPTION_REL_RATE, 0, "rel-rate", "HZ",
+                  "send emulated mouse movement and scrolling HZ times per "
+                  "second (default: 100)")
+      .add_option(OPTION_WHEEL_HI_RES, 0, "wheel-hi-res", "",
+                  "add high resolution scroll wheel events for smooth "
+                  "scrolling")
       .add_option(
           OPTION_DEVICE_NAME, 0, "device-name", "NAME",
           "Changes the name prefix used for devices in the current slot")
@@ -449,12 +484,14 @@ void CommandLineParser::init_ini(Options* opts) {
 
   m_ini.section("xboxdrv")("verbose", std::bind(&Options::set_verbose, opts),
                            std::function<void()>())("silent", &opts->silent)(
+      "monitor", &opts->monitor)("export-state", &opts->export_state)(
       "quiet", &opts->quiet)("usb-debug", &opts->usb_debug)(
       "rumble", &opts->rumble)("led", std::bind(&Options::set_led, opts, _1))(
       "rumble-l", &opts->rumble_l)("rumble-r", &opts->rumble_r)(
       "rumble-gain", std::bind(&Options::set_rumble_gain, opts, _1))(
       "controller-id", &opts->controller_id)("wireless-id", &opts->wireless_id)(
       "instant-exit", &opts->instant_exit)("no-uinput", &opts->no_uinput)(
+      "uinput-socket", &opts->uinput_socket)(
       "detach-kernel-driver", &opts->detach_kernel_driver)(
       "busid", &opts->busid)("devid", &opts->devid)(
       "vendor-id", &opts->vendor_id)("product-id", &opts->product_id)(
@@ -463,11 +500,16 @@ void CommandLineParser::init_ini(Options* opts) {
       "config", std::bind(&CommandLineParser::read_config_file, this, _1))(
       "alt-config", std::bind(&CommandLineParser::read_alt_config_file, this,
                               _1))("timeout", &opts->timeout)(
+      "decimation", std::bind(&Options::set_decimation, opts, _1))(
       "priority", std::bind(&Options::set_priority, opts, _1))(
+      "mlock", &opts->mlock)(
+      "cpu-affinity", std::bind(&Options::set_cpu_affinity, opts, _1))(
       "next", std::bind(&Options::next_config, opts), std::function<void()>())(
       "next-controller", std::bind(&Options::next_controller, opts),
       std::function<void()>())("extra-devices", &opts->extra_devices)(
       "extra-events", &opts->extra_events)(
+      "rel-rate", std::bind(&Options::set_rel_rate, opts, _1))(
+      "wheel-hi-res", &opts->wheel_hi_res)(
       "toggle", std::bind(&Options::set_toggle_button, opts, _1))(
       "ff-device", std::bind(&Options::set_ff_device, opts, _1))
 
@@ -605,6 +647,13 @@ void CommandLineParser::parse_args(int argc, char** argv, Options* options) {
   init_ini(options);
   m_options = options;
 
+  // remember the command line, so that the daemon can reload it
+  opts.args.assign(argv, argv + argc);
+  char cwd[PATH_MAX];
+  if (getcwd(cwd, sizeof(cwd))) {
+    opts.working_directory = cwd;
+  }
+
   ArgParser::ParsedOptions parsed = m_argp.parse_args(argc, argv);
 
   for (ArgParser::ParsedOptions::const_iterator i = parsed.begin();
@@ -650,6 +699,14 @@ void CommandLineParser::apply_opt(ArgParser::ParsedOption const& opt,
       opts.silent = true;
       break;
 
+    case OPTION_MONITOR:
+      opts.monitor = opt.argument;
+      break;
+
+    case OPTION_EXPORT_STATE:
+      opts.export_state = opt.argument;
+      break;
+
     case OPTION_DEBUG:
       opts.set_debug();
       break;
@@ -662,6 +719,14 @@ void CommandLineParser::apply_opt(ArgParser::ParsedOption const& opt,
       opts.set_priority(opt.argument);
       break;
 
+    case OPTION_MLOCK:
+      opts.mlock = true;
+      break;
+
+    case OPTION_CPU_AFFINITY:
+      opts.set_cpu_affinity(opt.argument);
+      break;
+
     case OPTION_DAEMON:
       opts.set_daemon();
       break;
@@ -732,10 +797,18 @@ void CommandLineParser::apply_opt(ArgParser::ParsedOption const& opt,
       opts.timeout = std::stoi(opt.argument);
       break;
 
+    case OPTION_DECIMATION:
+      opts.set_decimation(opt.argument);
+      break;
+
     case OPTION_NO_UINPUT:
       opts.no_uinput = true;
       break;
 
+    case OPTION_UINPUT_SOCKET:
+      opts.uinput_socket = opt.argument;
+      break;
+
     case OPTION_MIMIC_XPAD:
       opts.set_mimic_xpad();
       break;
@@ -955,6 +1028,14 @@ void CommandLineParser::apply_opt(ArgParser::ParsedOption const& opt,
       opts.extra_events = false;
       break;
 
+    case OPTION_REL_RATE:
+      opts.set_rel_rate(opt.argument);
+      break;
+
+    case OPTION_WHEEL_HI_RES:
+      opts.wheel_hi_res = true;
+      break;
+
     case OPTION_DPAD_ONLY:
       opts.set_dpad_only();
       break;
@@ -1399,16 +1480,9 @@ void CommandLineParser::read_buildin_config_file(const std::string& filename,
                                                  unsigned int data_len) {
   log_info("reading 'buildin://" << filename << "'");
 
-  std::string str(data, data_len);
-  std::istringstream in(str);
-  if (!in) {
-    raise_exception(std::runtime_error,
-                    "couldn't open: buildin://" << filename);
-  } else {
-    INISchemaBuilder builder(m_ini);
-    INIParser parser(in, builder, filename);
-    parser.run();
-  }
+  INISchemaBuilder builder(m_ini);
+  INIParser parser(std::string_view(data, data_len), builder, filename);
+  parser.run();
 }
 
 void CommandLineParser::read_config_file(const std::string& filename) {
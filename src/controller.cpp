@@ -18,11 +18,13 @@
 
 #include "controller.hpp"
 
+#include "helper.hpp"
 #include "log.hpp"
 #include "message_processor.hpp"
 
 Controller::Controller()
     : m_msg_cb(),
+      m_key_cb(),
       m_disconnect_cb(),
       m_activation_cb(),
       m_is_disconnected(false),
@@ -38,7 +40,14 @@ Controller::~Controller() { udev_device_unref(m_udev_device); }
 
 void Controller::submit_msg(const XboxGenericMsg& msg) {
   if (m_msg_cb) {
-    m_msg_cb(msg);
+    // stamped once here, everything later in the pipeline uses this
+    m_msg_cb(msg, get_time_nsec());
+  }
+}
+
+void Controller::submit_keys(const std::vector<ControllerKey>& keys) {
+  if (m_key_cb) {
+    m_key_cb(keys, get_time_nsec());
   }
 }
 
@@ -85,10 +94,16 @@ void Controller::set_udev_device(udev_device* udev_dev) {
 }
 
 void Controller::set_message_cb(
-    const std::function<void(const XboxGenericMsg&)>& msg_cb) {
+    const std::function<void(const XboxGenericMsg&, int64_t)>& msg_cb) {
   m_msg_cb = msg_cb;
 }
 
+void Controller::set_key_cb(
+    const std::function<void(const std::vector<ControllerKey>&, int64_t)>&
+        key_cb) {
+  m_key_cb = key_cb;
+}
+
 udev_device* Controller::get_udev_device() const { return m_udev_device; }
 
 void Controller::set_active(bool v) {
@@ -33,9 +33,17 @@ struct ff_effect;
 class MessageProcessor;
 struct XboxGenericMsg;
 
+/** A key of a keyboard attached to the controller, such as the
+    chatpad, that was pressed or released */
+struct ControllerKey {
+  int code;  /// linux KEY_* code
+  bool value;
+};
+
 class Controller {
  protected:
-  std::function<void(const XboxGenericMsg&)> m_msg_cb;
+  std::function<void(const XboxGenericMsg&, int64_t)> m_msg_cb;
+  std::function<void(const std::vector<ControllerKey>&, int64_t)> m_key_cb;
   std::function<void()> m_disconnect_cb;
   std::function<void()> m_activation_cb;
   bool m_is_disconnected;
@@ -89,12 +97,23 @@ class Controller {
   virtual std::string get_usbid() const { return "-1:-1"; }
   virtual std::string get_name() const { return "<not implemented>"; }
 
-  void set_message_cb(const std::function<void(const XboxGenericMsg&)>& msg_cb);
+  /** \a msg_cb gets each message with the CLOCK_MONOTONIC time in
+      nsec at which it arrived */
+  void set_message_cb(
+      const std::function<void(const XboxGenericMsg&, int64_t)>& msg_cb);
+
+  /** \a key_cb gets all keys that changed in one report of an
+      attached keyboard, with the CLOCK_MONOTONIC time in nsec at which
+      it arrived */
+  void set_key_cb(
+      const std::function<void(const std::vector<ControllerKey>&, int64_t)>&
+          key_cb);
 
   void set_udev_device(udev_device* udev_dev);
   udev_device* get_udev_device() const;
 
   void submit_msg(const XboxGenericMsg& msg);
+  void submit_keys(const std::vector<ControllerKey>& keys);
 
   const std::vector<uint16_t>& get_ff_features() { return m_ff_features; }
   int get_num_ff_effects() { return m_num_ff_effects; }
@@ -19,6 +19,7 @@
 #include "controller_factory.hpp"
 
 #include <cassert>
+#include <memory>
 #include <stdexcept>
 
 #include "firestorm_dual_controller.hpp"
@@ -29,6 +30,7 @@
 #include "t_wireless_controller.hpp"
 #include "xbox360_controller.hpp"
 #include "xbox360_wireless_controller.hpp"
+#include "xbox360_wireless_receiver.hpp"
 #include "xbox_controller.hpp"
 
 ControllerPtr ControllerFactory::create(const XPadDevice& dev_type,
@@ -63,7 +65,9 @@ ControllerPtr ControllerFactory::create(const XPadDevice& dev_type,
 
     case GAMEPAD_XBOX360_WIRELESS:
       return ControllerPtr(new Xbox360WirelessController(
-          dev, opts.wireless_id, opts.detach_kernel_driver));
+          std::make_shared<Xbox360WirelessReceiver>(dev,
+                                                    opts.detach_kernel_driver),
+          opts.wireless_id));
 
     case GAMEPAD_FIRESTORM:
       return ControllerPtr(
@@ -135,9 +139,16 @@ std::vector<ControllerPtr> ControllerFactory::create_multiple(
       break;
 
     case GAMEPAD_XBOX360_WIRELESS:
-      for (int wireless_id = 0; wireless_id < 4; ++wireless_id) {
-        lst.push_back(ControllerPtr(new Xbox360WirelessController(
-            dev, wireless_id, opts.detach_kernel_driver)));
+      {
+        // all pads share the receivers device handle and transfers
+        std::shared_ptr<Xbox360WirelessReceiver> receiver =
+            std::make_shared<Xbox360WirelessReceiver>(
+                dev, opts.detach_kernel_driver);
+        for (int wireless_id = 0;
+             wireless_id < Xbox360WirelessReceiver::kNumPads; ++wireless_id) {
+          lst.push_back(ControllerPtr(
+              new Xbox360WirelessController(receiver, wireless_id)));
+        }
       }
       break;
 
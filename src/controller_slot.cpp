@@ -22,6 +22,9 @@
 #include <memory>
 
 #include "dummy_message_processor.hpp"
+#include "options.hpp"
+#include "state_export.hpp"
+#include "uinput.hpp"
 #include "uinput_message_processor.hpp"
 
 ControllerSlot::ControllerSlot(int id_, ControllerSlotConfigPtr config_,
@@ -34,18 +37,48 @@ ControllerSlot::ControllerSlot(int id_, ControllerSlotConfigPtr config_,
       m_led_status(led_status_),
       m_thread(),
       m_opts(opts),
-      m_uinput(uinput) {}
+      m_uinput(uinput),
+      m_state_export() {
+  if (!m_opts.export_state.empty()) {
+    m_state_export.reset(
+        new StateExport(m_opts.export_state + std::to_string(m_id)));
+  }
+}
 
-void ControllerSlot::connect(ControllerPtr controller) {
-  assert(!m_thread);
+ControllerSlot::~ControllerSlot() {}
 
+std::shared_ptr<MessageProcessor> ControllerSlot::create_message_proc()
+    const {
   std::shared_ptr<MessageProcessor> message_proc;
   if (m_uinput) {
-    message_proc.reset(new UInputMessageProcessor(*m_uinput, m_config, m_opts));
+    UInputMessageProcessor* uinput_proc =
+        new UInputMessageProcessor(*m_uinput, m_config, m_opts);
+    uinput_proc->set_state_export(m_state_export.get());
+    message_proc.reset(uinput_proc);
   } else {
     message_proc.reset(new DummyMessageProcessor());
   }
-  m_thread.reset(new ControllerThread(controller, message_proc, m_opts));
+  return message_proc;
+}
+
+void ControllerSlot::connect(ControllerPtr controller) {
+  assert(!m_thread);
+
+  m_thread.reset(
+      new ControllerThread(controller, create_message_proc(), m_opts));
+}
+
+void ControllerSlot::reconfigure(ControllerSlotConfigPtr config,
+                                 std::vector<ControllerMatchRulePtr> rules,
+                                 int led_status, UInput* uinput) {
+  m_config = config;
+  m_rules = rules;
+  m_led_status = led_status;
+  m_uinput = uinput;
+
+  if (m_thread) {
+    m_thread->set_message_proc(create_message_proc());
+  }
 }
 
 ControllerPtr ControllerSlot::disconnect() {
@@ -57,6 +90,14 @@ ControllerPtr ControllerSlot::disconnect() {
   return controller;
 }
 
+std::vector<std::string> ControllerSlot::get_devnodes() const {
+  if (m_uinput) {
+    return m_uinput->get_devnodes(m_id);
+  } else {
+    return std::vector<std::string>();
+  }
+}
+
 bool ControllerSlot::is_connected() const {
   return static_cast<bool>(m_thread);
 }
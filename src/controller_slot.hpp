@@ -19,11 +19,15 @@
 #ifndef HEADER_XBOXDRV_CONTROLLER_SLOT_HPP
 #define HEADER_XBOXDRV_CONTROLLER_SLOT_HPP
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "controller_slot_config.hpp"
 #include "controller_thread.hpp"
 
+class StateExport;
+
 class ControllerSlot {
  private:
   int m_id;
@@ -35,15 +39,26 @@ class ControllerSlot {
   const Options& m_opts;
   UInput* m_uinput;
 
+  /** outlives the message processors, so readers keep their mapping
+      across reconfigurations */
+  std::unique_ptr<StateExport> m_state_export;
+
  public:
   ControllerSlot(int id_, ControllerSlotConfigPtr config_,
                  std::vector<ControllerMatchRulePtr> rules_, int led_status_,
                  const Options& opts, UInput* uinput);
+  ~ControllerSlot();
 
   bool is_connected() const;
   void connect(ControllerPtr controller);
   ControllerPtr disconnect();
 
+  /** Switches the slot over to a new configuration, a connected
+      controller stays connected and continues with the new one */
+  void reconfigure(ControllerSlotConfigPtr config,
+                   std::vector<ControllerMatchRulePtr> rules, int led_status,
+                   UInput* uinput);
+
   const std::vector<ControllerMatchRulePtr>& get_rules() const {
     return m_rules;
   }
@@ -51,11 +66,17 @@ class ControllerSlot {
   int get_id() const { return m_id; }
   ControllerSlotConfigPtr get_config() const { return m_config; }
 
+  /** The /dev/input nodes of the devices of this slot */
+  std::vector<std::string> get_devnodes() const;
+
   ControllerThreadPtr get_thread() const { return m_thread; }
   ControllerPtr get_controller() const {
     return m_thread ? m_thread->get_controller() : ControllerPtr();
   }
 
+ private:
+  std::shared_ptr<MessageProcessor> create_message_proc() const;
+
  private:
   ControllerSlot(const ControllerSlot&);
   ControllerSlot& operator=(const ControllerSlot&);
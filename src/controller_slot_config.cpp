@@ -23,14 +23,16 @@
 #include <stdexcept>
 
 #include "axisfilter/deadzone_axis_filter.hpp"
+#include "chatpad.hpp"
 #include "modifier/dpad_rotation_modifier.hpp"
 #include "modifier/four_way_restrictor_modifier.hpp"
 #include "modifier/square_axis_modifier.hpp"
 #include "raise_exception.hpp"
+#include "ui_event.hpp"
 #include "uinput.hpp"
 
 ControllerSlotConfigPtr ControllerSlotConfig::create(
-    UInput& uinput, int slot, bool extra_devices,
+    UInput& uinput, int slot, bool extra_devices, bool chatpad,
     const ControllerSlotOptions& opts, Controller* controller) {
   ControllerSlotConfigPtr m_config(new ControllerSlotConfig);
 
@@ -55,6 +57,17 @@ ControllerSlotConfigPtr ControllerSlotConfig::create(
 #endif
   }
 
+  if (chatpad) {
+    // the chatpad keys go to the same devices as KEY_* bindings do
+    std::vector<int> keys = Chatpad::get_keys();
+    for (std::vector<int>::const_iterator i = keys.begin(); i != keys.end();
+         ++i) {
+      UIEvent event = UIEvent::create(DEVICEID_AUTO, EV_KEY, *i);
+      event.resolve_device_id(slot, extra_devices);
+      m_config->m_keys[*i] = uinput.add_key(event.get_device_id(), *i);
+    }
+  }
+
   // LED
   // ioctl(fd, UI_SET_EVBIT, EV_LED);
   // ioctl(fd, UI_SET_LEDBIT, LED_MISC);
@@ -195,7 +208,7 @@ void ControllerSlotConfig::create_modifier(const ControllerOptions& opts,
 }
 
 ControllerSlotConfig::ControllerSlotConfig()
-    : m_config(), m_current_config(0), m_controller() {}
+    : m_config(), m_current_config(0), m_controller(), m_keys() {}
 
 void ControllerSlotConfig::next_config() {
   m_current_config += 1;
@@ -238,6 +251,13 @@ ControllerConfigPtr ControllerSlotConfig::get_config() const {
   return m_config[m_current_config];
 }
 
+void ControllerSlotConfig::send_key(int code, bool value) {
+  std::map<int, UIEventEmitterPtr>::iterator it = m_keys.find(code);
+  if (it != m_keys.end()) {
+    it->second->send(value);
+  }
+}
+
 void ControllerSlotConfig::add_config(ControllerConfigPtr config) {
   m_config.push_back(config);
 }
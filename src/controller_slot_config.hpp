@@ -20,10 +20,12 @@
 #define HEADER_XBOXDRV_CONTROLLER_CONFIG_SET_HPP
 
 #include <functional>
+#include <map>
 #include <memory>
 
 #include "controller_config.hpp"
 #include "options.hpp"
+#include "ui_event_emitter.hpp"
 
 class Options;
 class UInput;
@@ -35,9 +37,9 @@ typedef std::shared_ptr<ControllerSlotConfig> ControllerSlotConfigPtr;
 class ControllerSlotConfig {
  public:
   /** Creates a ControllerSlotConfig from the Options object and connects it to
-   * UInput */
+   * UInput, with \a chatpad the chatpad keys are registered as well */
   static ControllerSlotConfigPtr create(UInput& uinput, int slot,
-                                        bool extra_devices,
+                                        bool extra_devices, bool chatpad,
                                         const ControllerSlotOptions& opts,
                                         Controller* controller);
 
@@ -50,6 +52,10 @@ class ControllerSlotConfig {
   int m_current_config;
   Controller* m_controller;
 
+  /** emitters for the keys of an attached keyboard, by KEY_* code,
+      they stay the same when the config is switched */
+  std::map<int, UIEventEmitterPtr> m_keys;
+
  public:
   ControllerSlotConfig();
 
@@ -66,6 +72,10 @@ class ControllerSlotConfig {
 
   bool empty() const { return m_config.empty(); }
 
+  /** Sends a key of an attached keyboard, keys that weren't
+      registered in create() are ignored */
+  void send_key(int code, bool value);
+
  private:
   ControllerSlotConfig(const ControllerSlotConfig&);
   ControllerSlotConfig& operator=(const ControllerSlotConfig&);
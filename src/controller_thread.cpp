@@ -20,6 +20,7 @@
 
 #include <glib.h>
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <iostream>
@@ -28,6 +29,7 @@
 #include "controller.hpp"
 #include "helper.hpp"
 #include "log.hpp"
+#include "message_monitor.hpp"
 #include "message_processor.hpp"
 
 using std::placeholders::_1;
@@ -42,45 +44,134 @@ ControllerThread::ControllerThread(ControllerPtr controller,
       m_processor(processor),
       m_oldrealmsg(),
       m_timeout(opts.timeout),
-      m_print_messages(!opts.silent),
+      m_print_messages(!opts.silent && opts.monitor.empty()),
       m_timeout_id(),
-      m_timer(g_timer_new()) {
+      m_last_time(get_time_nsec()),
+      m_monitor(),
+      m_monitor_source(0),
+      m_decimation(opts.decimation),
+      m_decimation_id(),
+      m_msg_queue() {
   memset(&m_oldrealmsg, 0, sizeof(m_oldrealmsg));
-  m_timeout_id =
-      g_timeout_add(m_timeout, &ControllerThread::on_timeout_wrap, this);
+  if (!opts.monitor.empty()) {
+    m_monitor = MessageMonitor::get(opts.monitor);
+    m_monitor_source = m_monitor->add_source();
+  }
   m_controller->set_message_cb(
-      std::bind(&ControllerThread::on_message, this, _1));
+      std::bind(&ControllerThread::on_message, this, _1, _2));
+  m_controller->set_key_cb(std::bind(&ControllerThread::on_keys, this, _1, _2));
   m_processor->set_controller(m_controller.get());
 }
 
 ControllerThread::~ControllerThread() {
-  g_source_remove(m_timeout_id);
-  g_timer_destroy(m_timer);
+  if (m_decimation_id) {
+    g_source_remove(m_decimation_id);
+  }
+  if (m_timeout_id) {
+    g_source_remove(m_timeout_id);
+  }
+}
+
+void ControllerThread::set_message_proc(
+    std::shared_ptr<MessageProcessor> processor) {
+  m_processor = processor;
+  m_processor->set_controller(m_controller.get());
+  m_processor->send(m_oldrealmsg, get_time_nsec(), 0);
+  update_timeout();
+}
+
+void ControllerThread::update_timeout() {
+  if (!m_timeout_id && m_processor.get() && m_processor->needs_update()) {
+    m_timeout_id =
+        g_timeout_add(m_timeout, &ControllerThread::on_timeout_wrap, this);
+  }
 }
 
 bool ControllerThread::on_timeout() {
   if (m_processor.get()) {
-    int msec_delta = static_cast<int>(g_timer_elapsed(m_timer, NULL) * 1000.0f);
-    g_timer_reset(m_timer);
+    int64_t now = get_time_nsec();
+    int64_t nsec_delta = now - m_last_time;
+    m_last_time = now;
 
-    m_processor->send(m_oldrealmsg, msec_delta);
+    m_processor->send(m_oldrealmsg, now, nsec_delta);
   }
 
-  return true;  // do not remove the callback
+  if (m_processor.get() && m_processor->needs_update()) {
+    return true;
+  } else {
+    m_timeout_id = 0;
+    return false;
+  }
 }
 
-void ControllerThread::on_message(const XboxGenericMsg& msg) {
-  if (m_print_messages) {
+void ControllerThread::on_message(const XboxGenericMsg& msg, int64_t time) {
+  if (m_monitor) {
+    m_monitor->write(m_monitor_source, msg, time);
+  } else if (m_print_messages) {
     std::cout << msg << std::endl;
   }
 
+  if (m_decimation <= 0) {
+    process_message(msg, time);
+  } else if (!m_decimation_id) {
+    // nothing processed recently, so don't delay this one
+    process_message(msg, time);
+    m_decimation_id = g_timeout_add(
+        m_decimation, &ControllerThread::on_decimation_timeout_wrap, this);
+  } else if (!m_msg_queue.empty() &&
+             same_buttons(m_msg_queue.back().msg, msg)) {
+    // axes only take the latest value
+    m_msg_queue.back().msg = msg;
+    m_msg_queue.back().time = time;
+  } else {
+    QueuedMsg queued;
+    queued.msg = msg;
+    queued.time = time;
+    m_msg_queue.push_back(queued);
+  }
+}
+
+void ControllerThread::on_keys(const std::vector<ControllerKey>& keys,
+                               int64_t time) {
+  // key changes are never merged, so they bypass the decimation
+  if (m_processor.get()) {
+    m_processor->send_keys(keys, time);
+  }
+}
+
+void ControllerThread::process_message(const XboxGenericMsg& msg,
+                                       int64_t time) {
   m_oldrealmsg = msg;
 
-  int msec_delta = static_cast<int>(g_timer_elapsed(m_timer, NULL) * 1000.0f);
-  g_timer_reset(m_timer);
+  // a message can be older than the last timeout, when it was queued
+  // by the decimation
+  int64_t nsec_delta = std::max<int64_t>(time - m_last_time, 0);
+  m_last_time = std::max(time, m_last_time);
+
+  if (!m_timeout_id) {
+    // nothing was running while the timeout was off, so don't let the
+    // idle time count, a running timeout wouldn't have let it either
+    nsec_delta = std::min(nsec_delta, msec2nsec(m_timeout));
+  }
 
   if (m_processor.get()) {
-    m_processor->send(msg, msec_delta);
+    m_processor->send(msg, time, nsec_delta);
+    update_timeout();
+  }
+}
+
+bool ControllerThread::on_decimation_timeout() {
+  if (m_msg_queue.empty()) {
+    // nothing arrived in this window, close it
+    m_decimation_id = 0;
+    return false;
+  } else {
+    for (std::vector<QueuedMsg>::iterator i = m_msg_queue.begin();
+         i != m_msg_queue.end(); ++i) {
+      process_message(i->msg, i->time);
+    }
+    m_msg_queue.clear();
+    return true;
   }
 }
 
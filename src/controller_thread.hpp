@@ -21,16 +21,20 @@
 
 #include <glib.h>
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "controller_ptr.hpp"
 #include "controller_slot_config.hpp"
 #include "controller_slot_ptr.hpp"
 
 class Options;
+class MessageMonitor;
 class MessageProcessor;
 class ControllerThread;
 class Controller;
+struct ControllerKey;
 
 typedef std::shared_ptr<ControllerThread> ControllerThreadPtr;
 
@@ -42,12 +46,32 @@ class ControllerThread  // FIXME: find a better name,ControllerLoop?!
   ControllerPtr m_controller;
   std::shared_ptr<MessageProcessor> m_processor;
 
-  XboxGenericMsg m_oldrealmsg;  /// last data read from the device
+  XboxGenericMsg m_oldrealmsg;  /// last data passed to the processor
 
+  /** the last message is sent again every m_timeout msec, but only
+      while the processor needs_update(), an idle controller causes no
+      wakeups */
   int m_timeout;
   bool m_print_messages;
   guint m_timeout_id;
-  GTimer* m_timer;
+  /** CLOCK_MONOTONIC nsec of the last message passed to the processor */
+  int64_t m_last_time;
+
+  /** when set, messages go to the monitor instead of stdout */
+  std::shared_ptr<MessageMonitor> m_monitor;
+  uint32_t m_monitor_source;
+
+  /** messages arriving within m_decimation msec after a processed one
+      are collected in m_msg_queue and processed together when the
+      window ends, a message only replaces the last queued one when
+      both have the same buttons pressed, so no button change is lost */
+  int m_decimation;
+  guint m_decimation_id;
+  struct QueuedMsg {
+    XboxGenericMsg msg;
+    int64_t time;
+  };
+  std::vector<QueuedMsg> m_msg_queue;
 
  public:
   ControllerThread(ControllerPtr controller,
@@ -56,16 +80,30 @@ class ControllerThread  // FIXME: find a better name,ControllerLoop?!
   ~ControllerThread();
 
   MessageProcessor* get_message_proc() const { return m_processor.get(); }
+
+  /** Replaces the MessageProcessor and passes the last message
+      received from the controller through the new one right away */
+  void set_message_proc(std::shared_ptr<MessageProcessor> processor);
   ControllerPtr get_controller() const { return m_controller; }
 
  private:
-  void on_message(const XboxGenericMsg& msg);
+  void on_message(const XboxGenericMsg& msg, int64_t time);
+  void on_keys(const std::vector<ControllerKey>& keys, int64_t time);
+  void process_message(const XboxGenericMsg& msg, int64_t time);
+
+  /** Starts the timeout if the processor needs it */
+  void update_timeout();
 
   bool on_timeout();
   static gboolean on_timeout_wrap(gpointer data) {
     return static_cast<ControllerThread*>(data)->on_timeout();
   }
 
+  bool on_decimation_timeout();
+  static gboolean on_decimation_timeout_wrap(gpointer data) {
+    return static_cast<ControllerThread*>(data)->on_decimation_timeout();
+  }
+
  private:
   ControllerThread(const ControllerThread&);
   ControllerThread& operator=(const ControllerThread&);
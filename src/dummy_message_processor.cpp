@@ -20,7 +20,8 @@
 
 DummyMessageProcessor::DummyMessageProcessor() {}
 
-void DummyMessageProcessor::send(const XboxGenericMsg& msg, int msec_delta) {
+void DummyMessageProcessor::send(const XboxGenericMsg& msg, int64_t time,
+                                 int64_t nsec_delta) {
   // do nothing as the XboxdrvThread is already doing the printing
 }
 
@@ -26,7 +26,7 @@ class DummyMessageProcessor : public MessageProcessor {
  public:
   DummyMessageProcessor();
 
-  void send(const XboxGenericMsg& msg, int msec_delta);
+  void send(const XboxGenericMsg& msg, int64_t time, int64_t nsec_delta);
   virtual void set_controller(Controller* controller);
 
  private:
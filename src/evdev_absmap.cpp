@@ -18,57 +18,67 @@
 
 #include "evdev_absmap.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "helper.hpp"
+#include "raise_exception.hpp"
+
+namespace {
+
+void check_abs_code(int code) {
+  if (code < 0 || code >= ABS_CNT) {
+    raise_exception(std::runtime_error, "abs code out of range: " << code);
+  }
+}
+
+}  // namespace
 
-EvdevAbsMap::EvdevAbsMap() : m_plus_map(), m_minus_map(), m_both_map() {}
+EvdevAbsMap::EvdevAbsMap() { clear(); }
 
 void EvdevAbsMap::bind_plus(int code, XboxAxis axis) {
+  check_abs_code(code);
   m_plus_map[code] = axis;
 }
 
 void EvdevAbsMap::bind_minus(int code, XboxAxis axis) {
+  check_abs_code(code);
   m_minus_map[code] = axis;
 }
 
 void EvdevAbsMap::bind_both(int code, XboxAxis axis) {
+  check_abs_code(code);
   m_both_map[code] = axis;
 }
 
 void EvdevAbsMap::clear() {
-  m_plus_map.clear();
-  m_minus_map.clear();
-  m_both_map.clear();
+  std::fill_n(m_plus_map, ABS_CNT, XBOX_AXIS_UNKNOWN);
+  std::fill_n(m_minus_map, ABS_CNT, XBOX_AXIS_UNKNOWN);
+  std::fill_n(m_both_map, ABS_CNT, XBOX_AXIS_UNKNOWN);
 }
 
 void EvdevAbsMap::process(XboxGenericMsg& msg, int code, int value, int min,
                           int max) const {
-  {  // process plus map
-    std::map<int, XboxAxis>::const_iterator it = m_plus_map.find(code);
-    if (it != m_plus_map.end()) {
-      // '+ 1' so that we round up, instead of round down
-      const int center = (max - min + 1) / 2;
-      const float v = to_float(value, center, min);
-      set_axis_float(msg, it->second, v);
-    }
+  // process plus map
+  if (m_plus_map[code] != XBOX_AXIS_UNKNOWN) {
+    // '+ 1' so that we round up, instead of round down
+    const int center = (max - min + 1) / 2;
+    const float v = to_float(value, center, min);
+    set_axis_float(msg, m_plus_map[code], v);
   }
 
-  {  // process minus map
-    std::map<int, XboxAxis>::const_iterator it = m_minus_map.find(code);
-    if (it != m_minus_map.end()) {
-      // '+ 1' so that we round up, instead of round down
-      const int center = (max - min + 1) / 2;
-      const float v = to_float(value, center, max);
-      set_axis_float(msg, it->second, v);
-    }
+  // process minus map
+  if (m_minus_map[code] != XBOX_AXIS_UNKNOWN) {
+    // '+ 1' so that we round up, instead of round down
+    const int center = (max - min + 1) / 2;
+    const float v = to_float(value, center, max);
+    set_axis_float(msg, m_minus_map[code], v);
   }
 
-  {  // process minus map
-    std::map<int, XboxAxis>::const_iterator it = m_both_map.find(code);
-    if (it != m_both_map.end()) {
-      // '+ 1' so that we round up, instead of round down
-      const float v = to_float(value, min, max);
-      set_axis_float(msg, it->second, v);
-    }
+  // process both map
+  if (m_both_map[code] != XBOX_AXIS_UNKNOWN) {
+    const float v = to_float(value, min, max);
+    set_axis_float(msg, m_both_map[code], v);
   }
 }
 
@@ -19,12 +19,14 @@
 #ifndef HEADER_XBOXDRV_EVDEV_ABSMAP_HPP
 #define HEADER_XBOXDRV_EVDEV_ABSMAP_HPP
 
-#include <map>
+#include <linux/input.h>
 
 #include "xboxmsg.hpp"
 
 struct XboxGenericMsg;
 
+/** Maps EV_ABS codes to Xbox axes, the bindings are stored in arrays
+    indexed by the code, so that process() doesn't need any lookups */
 class EvdevAbsMap {
  public:
   EvdevAbsMap();
@@ -32,6 +34,13 @@ class EvdevAbsMap {
   void process(XboxGenericMsg& msg, int code, int value, int min,
                int max) const;
 
+  /** Returns true if \a code is bound to any axis */
+  bool is_bound(int code) const {
+    return m_plus_map[code] != XBOX_AXIS_UNKNOWN ||
+           m_minus_map[code] != XBOX_AXIS_UNKNOWN ||
+           m_both_map[code] != XBOX_AXIS_UNKNOWN;
+  }
+
   void bind_plus(int code, XboxAxis axis);
   void bind_minus(int code, XboxAxis axis);
   void bind_both(int code, XboxAxis axis);
@@ -39,9 +48,9 @@ class EvdevAbsMap {
   void clear();
 
  private:
-  std::map<int, XboxAxis> m_plus_map;
-  std::map<int, XboxAxis> m_minus_map;
-  std::map<int, XboxAxis> m_both_map;
+  XboxAxis m_plus_map[ABS_CNT];
+  XboxAxis m_minus_map[ABS_CNT];
+  XboxAxis m_both_map[ABS_CNT];
 };
 
 #endif
@@ -65,14 +65,8 @@ EvdevController::EvdevController(const std::string& filename,
       m_name(),
       m_grab(grab),
       m_debug(debug),
-      m_absmap(absmap),
-      m_keymap(keymap),
-      m_absinfo(ABS_MAX),
-      m_event_buffer(),
-      m_msg() {
-  memset(&m_msg, 0, sizeof(m_msg));
-  m_msg.type = XBOX_MSG_XBOX360;
-
+      m_mapper(absmap, keymap),
+      m_event_buffer() {
   m_fd = open(filename.c_str(), O_RDWR | O_NONBLOCK);
 
   if (m_fd == -1) {
@@ -113,7 +107,7 @@ EvdevController::EvdevController(const std::string& filename,
 
         log_debug(std::format("abs: {:20s} min: {:6d} max: {:6d}", abs2str(i),
                               absinfo.minimum, absinfo.maximum));
-        m_absinfo[i] = absinfo;
+        m_mapper.set_absinfo(i, absinfo);
       }
     }
 
@@ -213,66 +207,35 @@ void EvdevController::set_gain(int gain) {
   }
 }
 
-bool EvdevController::parse(const struct input_event& ev,
-                            XboxGenericMsg& msg_inout) const {
-  if (m_debug) {
-    switch (ev.type) {
-      case EV_KEY:
-        std::cout << "EV_KEY " << key2str(ev.code) << " " << ev.value
-                  << std::endl;
-        break;
-
-      case EV_REL:
-        std::cout << "EV_REL " << rel2str(ev.code) << " " << ev.value
-                  << std::endl;
-        break;
-
-      case EV_ABS:
-        std::cout << "EV_ABS " << abs2str(ev.code) << " " << ev.value
-                  << std::endl;
-        break;
-
-      case EV_SYN:
-        std::cout << "------------------- sync -------------------"
-                  << std::endl;
-        break;
-
-      case EV_MSC:
-        // FIXME: no idea what those are good for, but they pop up
-        // after key presses (something with scancodes maybe?!)
-        break;
-
-      default:
-        log_info("unknown: " << ev.type << " " << ev.code << " " << ev.value);
-        break;
-    }
-  }
-
+void EvdevController::print_event(const struct input_event& ev) const {
   switch (ev.type) {
-    case EV_KEY: {
-      KeyMap::const_iterator it = m_keymap.find(ev.code);
-      if (it != m_keymap.end()) {
-        set_button(msg_inout, it->second, ev.value);
-        return true;
-      } else {
-        return false;
-      }
-    } break;
-
-    case EV_ABS: {
-      const struct input_absinfo& absinfo = m_absinfo[ev.code];
-      m_absmap.process(msg_inout, ev.code,
-                       // some buggy USB devices report values
-                       // outside the given range, so we clamp it
-                       std::clamp(ev.value, absinfo.minimum, absinfo.maximum),
-                       absinfo.minimum, absinfo.maximum);
-      return true;  // FIXME: wrong
+    case EV_KEY:
+      std::cout << "EV_KEY " << key2str(ev.code) << " " << ev.value
+                << std::endl;
+      break;
+
+    case EV_REL:
+      std::cout << "EV_REL " << rel2str(ev.code) << " " << ev.value
+                << std::endl;
+      break;
+
+    case EV_ABS:
+      std::cout << "EV_ABS " << abs2str(ev.code) << " " << ev.value
+                << std::endl;
+      break;
+
+    case EV_SYN:
+      std::cout << "------------------- sync -------------------"
+                << std::endl;
+      break;
+
+    case EV_MSC:
+      // FIXME: no idea what those are good for, but they pop up
+      // after key presses (something with scancodes maybe?!)
       break;
-    }
 
     default:
-      // not supported event
-      return false;
+      log_info("unknown: " << ev.type << " " << ev.code << " " << ev.value);
       break;
   }
 }
@@ -284,10 +247,12 @@ gboolean EvdevController::on_read_data(GIOChannel* source,
   int rd = 0;
   while ((rd = ::read(m_fd, ev, sizeof(struct input_event) * 128)) > 0) {
     for (size_t i = 0; i < rd / sizeof(struct input_event); ++i) {
-      if (ev[i].type == EV_SYN) {
-        submit_msg(m_msg);
-      } else {
-        parse(ev[i], m_msg);
+      if (m_debug) {
+        print_event(ev[i]);
+      }
+
+      if (m_mapper.process(ev[i])) {
+        submit_msg(m_mapper.get_msg());
       }
     }
   }
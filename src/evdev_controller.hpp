@@ -27,6 +27,7 @@
 
 #include "controller.hpp"
 #include "evdev_absmap.hpp"
+#include "evdev_mapper.hpp"
 
 class EvdevAbsMap;
 
@@ -39,17 +40,11 @@ class EvdevController : public Controller {
   bool m_grab;
   bool m_debug;
 
-  EvdevAbsMap m_absmap;
+  EvdevMapper m_mapper;
 
-  typedef std::map<int, XboxButton> KeyMap;
-  KeyMap m_keymap;
-
-  std::vector<struct input_absinfo> m_absinfo;
   typedef std::queue<struct input_event> EventBuffer;
   EventBuffer m_event_buffer;
 
-  XboxGenericMsg m_msg;
-
  public:
   EvdevController(const std::string& filename, const EvdevAbsMap& absmap,
                   const std::map<int, XboxButton>& keyMap, bool grab,
@@ -71,7 +66,7 @@ class EvdevController : public Controller {
   bool read(XboxGenericMsg& msg, int timeout);
 
  private:
-  bool parse(const struct input_event& ev, XboxGenericMsg& msg_inout) const;
+  void print_event(const struct input_event& ev) const;
   void read_data_to_buffer();
 
   gboolean on_read_data(GIOChannel* source, GIOCondition condition);
@@ -20,52 +20,119 @@
 
 #include <linux/input.h>
 
+#ifdef HAVE_X11
+#include <X11/Xlib.h>
+#endif
+
+#include <array>
+#include <cstdlib>
 #include <stdexcept>
 #include <string>
 
 #include "helper.hpp"
 #include "log.hpp"
 
-EvDevRelEnum evdev_rel_names;
-EvDevKeyEnum evdev_key_names;
-EvDevAbsEnum evdev_abs_names;
+namespace {
+
+constexpr auto rel_symbols = std::to_array<Symbol<int> >({
+#include "rel_list.x"
+});
+
+constexpr auto abs_symbols = std::to_array<Symbol<int> >({
+#include "abs_list.x"
+});
+
+constexpr auto key_symbols = std::to_array<Symbol<int> >({
+#include "key_list.x"
+});
+
+constexpr auto x11keysym_symbols = std::to_array<Symbol<int> >({
+#include "x11keysym_list.x"
+});
+
+constexpr auto rel_table = make_symbol_table(rel_symbols);
+constexpr auto abs_table = make_symbol_table(abs_symbols);
+constexpr auto key_table = make_symbol_table(key_symbols);
+
+constexpr auto rel_index = make_symbol_index<REL_CNT>(rel_symbols);
+constexpr auto abs_index = make_symbol_index<ABS_CNT>(abs_symbols);
+constexpr auto key_index = make_symbol_index<KEY_CNT>(key_symbols);
+
+}  // namespace
+
+constinit const EvDevEnum evdev_rel_names("EV_REL", rel_table, rel_index);
+constinit const EvDevEnum evdev_key_names("EV_KEY", key_table, key_index);
+constinit const EvDevEnum evdev_abs_names("EV_ABS", abs_table, abs_index);
 
 const X11KeysymEnum& get_x11keysym_names() {
   static X11KeysymEnum x11keysym_names;
   return x11keysym_names;
 }
 
-EvDevRelEnum::EvDevRelEnum() :
-  EnumBox<int>("EV_REL")
-{
-#include "rel_list.x"
+int EvDevEnum::operator[](std::string_view str) const {
+  const Symbol<int>* sym = symbol_lookup(m_symbols, str);
+  if (!sym) {
+    std::ostringstream out;
+    out << "couldn't convert '" << str << "' to enum, not a member of "
+        << m_name << std::endl;
+    throw std::runtime_error(out.str());
+  } else {
+    return sym->value;
+  }
 }
 
-EvDevAbsEnum::EvDevAbsEnum() :
-    EnumBox<int>("EV_ABS")
-{
-#include "abs_list.x"
+std::string EvDevEnum::operator[](int v) const {
+  std::string_view name = find(v);
+  if (name.empty()) {
+    std::ostringstream out;
+    out << "couldn't convert '" << v << "' to string, not a member of "
+        << m_name << std::endl;
+    throw std::runtime_error(out.str());
+  } else {
+    return std::string(name);
+  }
 }
 
-EvDevKeyEnum::EvDevKeyEnum() :
-  EnumBox<int>("EV_KEY")
-{
-#include "key_list.x"
+std::string_view EvDevEnum::find(int v) const {
+  if (v < 0 || v >= static_cast<int>(m_names.size())) {
+    return std::string_view();
+  } else {
+    return m_names[v];
+  }
+}
+
+std::vector<std::string> EvDevEnum::get_names() const {
+  std::vector<std::string> lst;
+  for (std::string_view name : m_names) {
+    if (!name.empty()) {
+      lst.emplace_back(name);
+    }
+  }
+  return lst;
 }
 
 X11KeysymEnum::X11KeysymEnum() :
   EnumBox<int>("X11Keysym")
 {
+  if (!process_display()) {
+    process_builtin_table();
+  }
+}
+
+bool X11KeysymEnum::process_display() {
+#ifdef HAVE_X11
+  const char* display = getenv("DISPLAY");
+  if (!display || !*display) {
+    log_debug("no X11 display set, using builtin keysym table");
+    return false;
+  }
+
   Display* dpy = XOpenDisplay(NULL);
   if (!dpy) {
-    log_error("unable to open X11 display, X11 keynames will not be available");
-  } else {
-    process_keymap(dpy);
-    XCloseDisplay(dpy);
+    log_error("unable to open X11 display, using builtin keysym table");
+    return false;
   }
-}
 
-void X11KeysymEnum::process_keymap(Display* dpy) {
   int min_keycode, max_keycode;
   XDisplayKeycodes(dpy, &min_keycode, &max_keycode);
 
@@ -95,6 +162,18 @@ void X11KeysymEnum::process_keymap(Display* dpy) {
   }
 
   XFree(keymap);
+  XCloseDisplay(dpy);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void X11KeysymEnum::process_builtin_table() {
+  for (const Symbol<int>& sym : x11keysym_symbols) {
+    add(sym.value, std::string(sym.name));
+  }
 }
 
 int xkeysym2keycode(const std::string& name) {
@@ -197,9 +276,10 @@ UIEvent str2abs_event(const std::string& str) {
 }
 
 std::string key2str(int v) {
-  try {
-    return evdev_key_names[v];
-  } catch (const std::exception& err) {
+  std::string_view name = evdev_key_names.find(v);
+  if (!name.empty()) {
+    return std::string(name);
+  } else {
     std::ostringstream str;
     str << "KEY_#" << v;
     return str.str();
@@ -207,9 +287,10 @@ std::string key2str(int v) {
 }
 
 std::string abs2str(int v) {
-  try {
-    return evdev_abs_names[v];
-  } catch (const std::exception& err) {
+  std::string_view name = evdev_abs_names.find(v);
+  if (!name.empty()) {
+    return std::string(name);
+  } else {
     std::ostringstream str;
     str << "ABS_#" << v;
     return str.str();
@@ -217,9 +298,10 @@ std::string abs2str(int v) {
 }
 
 std::string rel2str(int v) {
-  try {
-    return evdev_rel_names[v];
-  } catch (const std::exception& err) {
+  std::string_view name = evdev_rel_names.find(v);
+  if (!name.empty()) {
+    return std::string(name);
+  } else {
     std::ostringstream str;
     str << "REL_#" << v;
     return str.str();
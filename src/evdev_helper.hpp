@@ -19,11 +19,13 @@
 #ifndef HEADER_EVDEV_HELPER_HPP
 #define HEADER_EVDEV_HELPER_HPP
 
-#include <X11/Xlib.h>
-
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "enum_box.hpp"
+#include "symbol_table.hpp"
 #include "ui_event.hpp"
 
 void str2event(const std::string& name, int& type, int& code);
@@ -41,32 +43,48 @@ UIEvent str2key_event(const std::string& str);
 UIEvent str2rel_event(const std::string& str);
 UIEvent str2abs_event(const std::string& str);
 
-class EvDevRelEnum : public EnumBox<int> {
- public:
-  EvDevRelEnum();
-};
+/** Maps evdev codes to names and back, the tables behind it are
+    generated at compile time from key_list.x, abs_list.x and
+    rel_list.x, so no setup happens at startup */
+class EvDevEnum {
+ private:
+  std::string_view m_name;
+  std::span<const Symbol<int> > m_symbols;
+  std::span<const std::string_view> m_names;
 
-class EvDevAbsEnum : public EnumBox<int> {
  public:
-  EvDevAbsEnum();
-};
+  constexpr EvDevEnum(std::string_view name,
+                      std::span<const Symbol<int> > symbols,
+                      std::span<const std::string_view> names)
+      : m_name(name), m_symbols(symbols), m_names(names) {}
 
-class EvDevKeyEnum : public EnumBox<int> {
- public:
-  EvDevKeyEnum();
+  int operator[](std::string_view str) const;
+  std::string operator[](int v) const;
+
+  /** Returns the name of \a v or an empty string_view if \a v has
+      none */
+  std::string_view find(int v) const;
+
+  std::vector<std::string> get_names() const;
 };
 
+/** Maps X11 keysym names (XK_...) to evdev keycodes. The mapping is
+    taken from the X11 display when one is configured and xboxdrv was
+    built with X11 support, otherwise from a builtin US layout table,
+    so headless setups never wait on an X11 connection. */
 class X11KeysymEnum : public EnumBox<int> {
  public:
   X11KeysymEnum();
 
  private:
-  void process_keymap(Display* dpy);
+  bool process_display();
+  void process_builtin_table();
 };
 
-extern EvDevRelEnum evdev_rel_names;
-extern EvDevKeyEnum evdev_key_names;
-extern EvDevAbsEnum evdev_abs_names;
+extern const EvDevEnum evdev_rel_names;
+extern const EvDevEnum evdev_key_names;
+extern const EvDevEnum evdev_abs_names;
+/** The table is created on first use */
 const X11KeysymEnum& get_x11keysym_names();
 
 #endif
@@ -0,0 +1,85 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2010 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "evdev_mapper.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+EvdevMapper::EvdevMapper(const EvdevAbsMap& absmap,
+                         const std::map<int, XboxButton>& keymap)
+    : m_absmap(absmap), m_msg(), m_last_msg(), m_dirty(false) {
+  std::fill_n(m_keymap, KEY_CNT, XBOX_BTN_UNKNOWN);
+  for (std::map<int, XboxButton>::const_iterator i = keymap.begin();
+       i != keymap.end(); ++i) {
+    if (i->first >= 0 && i->first < KEY_CNT) {
+      m_keymap[i->first] = i->second;
+    }
+  }
+
+  memset(m_absinfo, 0, sizeof(m_absinfo));
+
+  memset(&m_msg, 0, sizeof(m_msg));
+  m_msg.type = XBOX_MSG_XBOX360;
+  m_last_msg = m_msg;
+}
+
+void EvdevMapper::set_absinfo(int code, const struct input_absinfo& absinfo) {
+  m_absinfo[code] = absinfo;
+}
+
+bool EvdevMapper::process(const struct input_event& ev) {
+  switch (ev.type) {
+    case EV_KEY:
+      if (ev.code < KEY_CNT && m_keymap[ev.code] != XBOX_BTN_UNKNOWN) {
+        set_button(m_msg, m_keymap[ev.code], ev.value);
+        m_dirty = true;
+      }
+      return false;
+
+    case EV_ABS:
+      if (ev.code < ABS_CNT && m_absmap.is_bound(ev.code)) {
+        const struct input_absinfo& absinfo = m_absinfo[ev.code];
+        m_absmap.process(m_msg, ev.code,
+                         // some buggy USB devices report values
+                         // outside the given range, so we clamp it
+                         std::clamp(ev.value, absinfo.minimum, absinfo.maximum),
+                         absinfo.minimum, absinfo.maximum);
+        m_dirty = true;
+      }
+      return false;
+
+    case EV_SYN:
+      // mice and wheels report at up to 1 kHz, most of those frames
+      // don't touch a mapped event or end up with the same state
+      if (m_dirty) {
+        m_dirty = false;
+        if (memcmp(&m_msg, &m_last_msg, sizeof(m_msg)) != 0) {
+          m_last_msg = m_msg;
+          return true;
+        }
+      }
+      return false;
+
+    default:
+      // not supported event
+      return false;
+  }
+}
+
+/* EOF */
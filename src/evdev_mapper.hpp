@@ -0,0 +1,61 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2010 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_EVDEV_MAPPER_HPP
+#define HEADER_XBOXDRV_EVDEV_MAPPER_HPP
+
+#include <linux/input.h>
+
+#include <map>
+
+#include "evdev_absmap.hpp"
+#include "xboxmsg.hpp"
+
+/** Turns a stream of evdev events into XboxGenericMsg frames, all
+    tables are indexed by the event code and a frame is only handed
+    out on EV_SYN when a mapped event actually changed it */
+class EvdevMapper {
+ private:
+  EvdevAbsMap m_absmap;
+  XboxButton m_keymap[KEY_CNT];
+  struct input_absinfo m_absinfo[ABS_CNT];
+
+  XboxGenericMsg m_msg;
+  XboxGenericMsg m_last_msg;  /// last frame handed out
+  bool m_dirty;
+
+ public:
+  EvdevMapper(const EvdevAbsMap& absmap,
+              const std::map<int, XboxButton>& keymap);
+
+  void set_absinfo(int code, const struct input_absinfo& absinfo);
+
+  /** Returns true when \a ev completed a frame that differs from the
+      last one, the frame is then available via get_msg() */
+  bool process(const struct input_event& ev);
+
+  const XboxGenericMsg& get_msg() const { return m_msg; }
+
+ private:
+  EvdevMapper(const EvdevMapper&);
+  EvdevMapper& operator=(const EvdevMapper&);
+};
+
+#endif
+
+/* EOF */
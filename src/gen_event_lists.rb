@@ -8,7 +8,7 @@ def gen_event_list(regex, outfilename)
       name = i.split[1]; 
       if not name =~ /_MAX$/ and not name =~ /_CNT$/ 
         fout.puts "#ifdef #{name}"
-        fout.puts "  add(%s, \"%s\");" % [name, name]
+        fout.puts "  {\"%s\", %s}," % [name, name]
         fout.puts "#endif"
         fout.puts
       end
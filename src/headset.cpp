@@ -18,6 +18,8 @@
 
 #include "headset.hpp"
 
+#include <algorithm>
+#include <cassert>
 #include <cerrno>
 #include <cstring>
 #include <fstream>
@@ -27,66 +29,225 @@
 
 #include "helper.hpp"
 #include "raise_exception.hpp"
+#include "scheduling.hpp"
 #include "usb_helper.hpp"
 
 using std::placeholders::_1;
 using std::placeholders::_2;
 
+namespace {
+
+const int kPacketSize = 32;
+
+// number of playback transfers kept in flight, so that the next packet
+// is already queued when one completes
+const int kTransfersInFlight = 4;
+
+const size_t kRingBufferSize = 64 * 1024;
+
+// the I/O thread moves data in chunks of this size and is only woken
+// up once a whole chunk can be moved
+const size_t kIOChunkSize = 4096;
+
+}  // namespace
+
 Headset::Headset(libusb_device_handle* handle, bool debug)
     : m_handle(handle),
       m_interface(new USBInterface(m_handle, 1)),
       m_fout(),
-      m_fin() {}
+      m_fin(),
+      m_playback(kRingBufferSize),
+      m_record(kRingBufferSize),
+      m_io_thread(),
+      m_quit(false),
+      m_playback_eof(false),
+      m_io_mutex(),
+      m_io_cond(),
+      m_io_wakeup(false),
+      m_underruns(0),
+      m_overruns(0) {}
+
+Headset::~Headset() {
+  stop_io_thread();
 
-Headset::~Headset() { m_interface.reset(); }
+  m_interface.reset();
+
+  if (m_underruns || m_overruns) {
+    log_info("[headset] underruns: " << m_underruns
+                                     << " overruns: " << m_overruns);
+  }
+}
 
 void Headset::play_file(const std::string& filename) {
+  // the I/O thread reads the streams without a lock
+  stop_io_thread();
+
+  // the transfers of an earlier stream would keep reading from the
+  // ring buffer alongside the new ones
+  m_interface->cancel_write(4);
+  m_playback.clear();
+
   m_fin.reset(new std::ifstream(filename.c_str(), std::ios::binary));
 
   if (!*m_fin) {
     std::ostringstream out;
     out << "[headset] " << filename << ": " << strerror(errno);
+    m_fin.reset();
+    if (m_fout) {
+      start_io_thread();
+    }
     throw std::runtime_error(out.str());
   } else {
-    char data[32];
-    int len = m_fin->read(data, sizeof(data)).gcount();
-    if (len != 32) {
-      log_error("short read");
-    } else {
-      m_interface->submit_write(4, reinterpret_cast<uint8_t*>(data), len,
+    m_playback_eof = false;
+    start_io_thread();
+
+    // the first packets go out as silence, send_data() refills them
+    // from the ring buffer once the I/O thread got going
+    for (int i = 0; i < kTransfersInFlight; ++i) {
+      uint8_t data[kPacketSize] = {};
+      m_interface->submit_write(4, data, sizeof(data),
                                 std::bind(&Headset::send_data, this, _1));
     }
   }
 }
 
 void Headset::record_file(const std::string& filename) {
+  // the I/O thread reads the streams without a lock, stopping it also
+  // writes out what is left of an earlier recording
+  stop_io_thread();
+
+  m_interface->cancel_read(3);
+  m_record.clear();
+
   m_fout.reset(new std::ofstream(filename.c_str(), std::ios::binary));
 
   if (!*m_fout) {
-    raise_exception(std::runtime_error, filename << ": " << strerror(errno));
+    int err = errno;
+    m_fout.reset();
+    if (m_fin) {
+      start_io_thread();
+    }
+    raise_exception(std::runtime_error, filename << ": " << strerror(err));
   } else {
-    m_interface->submit_read(3, 32,
+    start_io_thread();
+    m_interface->submit_read(3, kPacketSize,
                              std::bind(&Headset::receive_data, this, _1, _2));
   }
 }
 
+void Headset::start_io_thread() {
+  assert(!m_io_thread.joinable());
+
+  m_quit = false;
+  m_io_thread = std::thread(&Headset::run_io_thread, this);
+}
+
+void Headset::stop_io_thread() {
+  if (m_io_thread.joinable()) {
+    m_quit = true;
+    wake_io_thread();
+    m_io_thread.join();
+  }
+}
+
+void Headset::wake_io_thread() {
+  if (!m_io_wakeup.exchange(true)) {
+    {
+      std::lock_guard<std::mutex> lock(m_io_mutex);
+    }
+    m_io_cond.notify_one();
+  }
+}
+
+void Headset::run_io_thread() {
+  setup_helper_thread_scheduling();
+
+  uint8_t buffer[4096];
+
+  while (!m_quit) {
+    // cleared before looking at the ring buffers, whatever the
+    // callbacks do meanwhile sets it again
+    m_io_wakeup.exchange(false);
+
+    bool busy = false;
+
+    if (m_fin && !m_playback_eof) {
+      size_t space = std::min(m_playback.write_available(), sizeof(buffer));
+      if (space > 0) {
+        std::streamsize len =
+            m_fin->read(reinterpret_cast<char*>(buffer), space).gcount();
+        m_playback.write(buffer, len);
+        if (!*m_fin) {
+          m_playback_eof = true;
+        }
+        busy = true;
+      }
+    }
+
+    if (m_fout) {
+      size_t len = m_record.read(buffer, sizeof(buffer));
+      if (len > 0) {
+        m_fout->write(reinterpret_cast<char*>(buffer), len);
+        busy = true;
+      }
+    }
+
+    if (!busy) {
+      // once playback hit the end and nothing is recorded this sleeps
+      // until the thread is stopped
+      std::unique_lock<std::mutex> lock(m_io_mutex);
+      m_io_cond.wait(lock, [this] { return m_quit || m_io_wakeup; });
+    }
+  }
+
+  // write out what is left of the recording
+  if (m_fout) {
+    size_t len;
+    while ((len = m_record.read(buffer, sizeof(buffer))) > 0) {
+      m_fout->write(reinterpret_cast<char*>(buffer), len);
+    }
+    m_fout->flush();
+  }
+}
+
 bool Headset::send_data(libusb_transfer* transfer) {
-  // fill the buffer with new data from the file
-  int len =
-      m_fin->read(reinterpret_cast<char*>(transfer->buffer), transfer->length)
-          .gcount();
-
-  if (len != 32) {
-    log_error("short read");
-    return false;
-  } else {
-    return true;
+  // fill the buffer with new data from the ring buffer
+  size_t length = transfer->length;
+  size_t len = m_playback.read(transfer->buffer, length);
+
+  if (len < length) {
+    if (m_playback_eof && m_playback.read_available() == 0 && len == 0) {
+      // playback is finished
+      return false;
+    }
+
+    if (!m_playback_eof) {
+      m_underruns += 1;
+    }
+
+    // pad with silence
+    memset(transfer->buffer + len, 0, length - len);
   }
+
+  if (!m_playback_eof && m_playback.write_available() >= kIOChunkSize) {
+    wake_io_thread();
+  }
+
+  return true;
 }
 
 bool Headset::receive_data(uint8_t* data, int len) {
   if (m_fout.get()) {
-    m_fout->write(reinterpret_cast<char*>(data), len);
+    // a partial packet would garble the recording, so a full ring
+    // drops the whole packet
+    if (m_record.write_available() < static_cast<size_t>(len)) {
+      m_overruns += 1;
+    } else {
+      m_record.write(data, len);
+      if (m_record.read_available() >= kIOChunkSize) {
+        wake_io_thread();
+      }
+    }
   }
   log_debug(raw2str(data, len));
 
@@ -21,11 +21,21 @@
 
 #include <libusb.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
+#include "ring_buffer.hpp"
 #include "usb_interface.hpp"
 
+/** Streams audio to and from the headset. File I/O happens on a
+    separate thread that exchanges data with the libusb callbacks
+    through lock-free ring buffers, so a slow disk shows up as an
+    underrun or overrun instead of stalling the main loop. */
 class Headset {
  private:
   libusb_device_handle* m_handle;
@@ -34,6 +44,22 @@ class Headset {
   std::shared_ptr<std::ofstream> m_fout;
   std::shared_ptr<std::ifstream> m_fin;
 
+  RingBuffer m_playback;
+  RingBuffer m_record;
+
+  std::thread m_io_thread;
+  std::atomic<bool> m_quit;
+  std::atomic<bool> m_playback_eof;
+
+  // the I/O thread sleeps until a chunk can be moved, m_io_wakeup is
+  // set by whoever wakes it
+  std::mutex m_io_mutex;
+  std::condition_variable m_io_cond;
+  std::atomic<bool> m_io_wakeup;
+
+  std::atomic<unsigned int> m_underruns;
+  std::atomic<unsigned int> m_overruns;
+
  public:
   Headset(libusb_device_handle* handle, bool debug);
   ~Headset();
@@ -41,7 +67,15 @@ class Headset {
   void play_file(const std::string& play_filename);
   void record_file(const std::string& dump_filename);
 
+  unsigned int get_underruns() const { return m_underruns; }
+  unsigned int get_overruns() const { return m_overruns; }
+
  private:
+  void start_io_thread();
+  void stop_io_thread();
+  void wake_io_thread();
+  void run_io_thread();
+
   bool send_data(libusb_transfer* transfer);
   bool receive_data(uint8_t* data, int len);
 
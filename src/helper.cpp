@@ -18,8 +18,12 @@
 
 #include "helper.hpp"
 
+#include <glib.h>
+#include <spawn.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -32,7 +36,35 @@
 #include <stdexcept>
 
 #include "helper.hpp"
+#include "log.hpp"
 #include "raise_exception.hpp"
+#include "scheduling.hpp"
+
+extern char** environ;
+
+namespace {
+
+void on_child_exit(GPid pid, gint status, gpointer userdata) {
+  std::function<void(int)>* on_exit =
+      static_cast<std::function<void(int)>*>(userdata);
+
+  if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+    log_debug("child " << pid << " exited with status "
+                       << WEXITSTATUS(status));
+  }
+
+  if (*on_exit) {
+    (*on_exit)(status);
+  }
+
+  g_spawn_close_pid(pid);
+}
+
+void delete_on_exit(gpointer userdata) {
+  delete static_cast<std::function<void(int)>*>(userdata);
+}
+
+}  // namespace
 
 int hexstr2int(const std::string& str) {
   unsigned int value = 0;
@@ -143,6 +175,12 @@ uint32_t get_time() {
   return tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
 
+int64_t get_time_nsec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
 float to_float_no_range_check(int value, int min, int max) {
   // FIXME: '+1' is kind of a hack to
   // get the center at 0 for the
@@ -182,25 +220,68 @@ pid_t spawn_exe(const std::string& arg0) {
   return spawn_exe(args);
 }
 
+pid_t spawn_exe(char* const* argv) {
+  assert(argv[0]);
+
+  // posix_spawnp() doesn't copy the address space like fork() does and
+  // the argv is already built, so nothing needs to run in the child
+  // before the exec
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+
+  pid_t pid;
+  int ret;
+  {
+    // the input thread runs at realtime priority, its children don't
+    ChildScheduling child_scheduling(&attr);
+    ret = posix_spawnp(&pid, argv[0], NULL, &attr, argv, environ);
+  }
+  posix_spawnattr_destroy(&attr);
+
+  if (ret != 0) {
+    log_error(argv[0] << ": exec failed: " << strerror(ret));
+    return -1;
+  } else {
+    return pid;
+  }
+}
+
 pid_t spawn_exe(const std::vector<std::string>& args) {
   assert(!args.empty());
 
-  pid_t pid = fork();
-  if (pid == 0) {
-    char** argv =
-        static_cast<char**>(malloc(sizeof(char*) * (args.size() + 1)));
-    for (size_t i = 0; i < args.size(); ++i) {
-      argv[i] = strdup(args[i].c_str());
-    }
-    argv[args.size()] = NULL;
+  std::vector<char*> argv = make_argv(args);
+  return spawn_exe(argv.data());
+}
 
-    if (execvp(args[0].c_str(), argv) == -1) {
-      log_error(args[0] << ": exec failed: " << strerror(errno));
-      _exit(EXIT_FAILURE);
-    }
+bool spawn_detached(char* const* argv,
+                    const std::function<void(int)>& on_exit) {
+  pid_t pid = spawn_exe(argv);
+  if (pid < 0) {
+    return false;
+  } else {
+    g_child_watch_add_full(G_PRIORITY_DEFAULT, pid, &on_child_exit,
+                           new std::function<void(int)>(on_exit),
+                           &delete_on_exit);
+    return true;
   }
+}
+
+bool spawn_detached(const std::vector<std::string>& args) {
+  assert(!args.empty());
+
+  std::vector<char*> argv = make_argv(args);
+  return spawn_detached(argv.data());
+}
 
-  return pid;
+std::vector<char*> make_argv(const std::vector<std::string>& args) {
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  for (std::vector<std::string>::const_iterator i = args.begin();
+       i != args.end(); ++i) {
+    argv.push_back(const_cast<char*>(i->c_str()));
+  }
+  argv.push_back(NULL);
+  return argv;
 }
 
 /* EOF */
@@ -68,6 +68,13 @@ std::string string_join(C const& c, std::string_view sep) {
 int to_number(int range, const std::string& str);
 uint32_t get_time();
 
+/** Returns CLOCK_MONOTONIC in nanoseconds */
+int64_t get_time_nsec();
+
+inline int64_t msec2nsec(int msec) {
+  return static_cast<int64_t>(msec) * 1000000;
+}
+
 // Change the sign
 inline int16_t s16_invert(int16_t v) {
   if (v) {
@@ -93,9 +100,23 @@ float to_float_no_range_check(int value, int min, int max);
 int from_float(float value, int min, int max);
 
 int get_terminal_width();
+/** Starts the program given by the NULL terminated \a argv via
+    posix_spawnp(), without waiting for it, returns -1 on failure */
+pid_t spawn_exe(char* const* argv);
 pid_t spawn_exe(const std::vector<std::string>& args);
 pid_t spawn_exe(const std::string& arg0);
 
+/** Like spawn_exe(), but the child is reaped from the main loop when
+    it exits, \a on_exit is then called with its wait status */
+bool spawn_detached(char* const* argv,
+                    const std::function<void(int)>& on_exit =
+                        std::function<void(int)>());
+bool spawn_detached(const std::vector<std::string>& args);
+
+/** Builds a NULL terminated argv pointing into \a args, which must
+    outlive it */
+std::vector<char*> make_argv(const std::vector<std::string>& args);
+
 #endif
 
 /* EOF */
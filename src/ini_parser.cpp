@@ -25,12 +25,36 @@
 
 INIParser::INIParser(std::istream& in, INIBuilder& builder,
                      const std::string& context)
-    : m_in(in),
+    : m_buffer(),
+      m_data(),
+      m_pos(0),
+      m_eof(false),
       m_builder(builder),
       m_context(context),
       m_line(1),
       m_column(0),
-      m_current_char(-1) {}
+      m_current_char(-1),
+      m_name(),
+      m_value() {
+  std::ostringstream str;
+  str << in.rdbuf();
+  m_buffer = str.str();
+  m_data = m_buffer;
+}
+
+INIParser::INIParser(std::string_view data, INIBuilder& builder,
+                     const std::string& context)
+    : m_buffer(),
+      m_data(data),
+      m_pos(0),
+      m_eof(false),
+      m_builder(builder),
+      m_context(context),
+      m_line(1),
+      m_column(0),
+      m_current_char(-1),
+      m_name(),
+      m_value() {}
 
 void INIParser::run() {
   // read the first char
@@ -38,7 +62,7 @@ void INIParser::run() {
 
   while (peek() != -1) {
     if (accept('[')) {
-      m_builder.send_section(get_section());
+      m_builder.send_section(std::string(get_section()));
       expect(']');
       whitespace();
       if (accept(';') || accept('#')) {
@@ -52,10 +76,9 @@ void INIParser::run() {
       newline();
     } else  // assume name=value pair
     {
-      std::string name;
-      std::string value;
+      m_value.clear();
 
-      name = get_ident_or_string();
+      get_ident_or_string(&m_name);
       whitespace();
 
       if (accept(';') || accept('#')) {  // "name"
@@ -67,7 +90,7 @@ void INIParser::run() {
           eat_rest_of_line();
           newline();
         } else {  // "name = value"
-          value = get_value_or_string();
+          get_value_or_string(&m_value);
           whitespace();
 
           if (accept(';') || accept('#')) {  // "name = value # comment"
@@ -79,7 +102,7 @@ void INIParser::run() {
         }
       }
 
-      m_builder.send_pair(name, value);
+      m_builder.send_pair(m_name, m_value);
     }
   }
 }
@@ -94,10 +117,14 @@ void INIParser::error(const std::string& message) {
 int INIParser::peek() { return m_current_char; }
 
 void INIParser::next() {
-  if (m_in.eof()) {
+  if (m_eof) {
     error("unexpected end of file");
+  } else if (m_pos >= m_data.size()) {
+    m_current_char = -1;
+    m_eof = true;
   } else {
-    m_current_char = m_in.get();
+    m_current_char = static_cast<unsigned char>(m_data[m_pos]);
+    m_pos += 1;
     if (m_current_char == '\n') {
       m_line += 1;
       m_column = 0;
@@ -129,32 +156,30 @@ void INIParser::expect(char c) {
   }
 }
 
-std::string INIParser::get_value_or_string() {
+void INIParser::get_value_or_string(std::string* out) {
   if (accept('"')) {
-    std::string str = get_string();
+    get_string(out);
     expect('"');
-    return str;
   } else {
-    return get_value();
+    *out = get_value();
   }
 }
 
-std::string INIParser::get_ident_or_string() {
+void INIParser::get_ident_or_string(std::string* out) {
   if (accept('"')) {
-    std::string str = get_string();
+    get_string(out);
     expect('"');
-    return str;
   } else {
-    return get_ident();
+    *out = get_ident();
   }
 }
 
-std::string INIParser::get_value() {
+std::string_view INIParser::get_value() {
   // an unquoted value is terminated either by a newline or a comment
   // character, whitespace at the end of the value will be trimmed
-  std::ostringstream str;
-  std::string::size_type last_char = std::string::npos;
-  std::string::size_type cur = 0;
+  std::string_view::size_type const start = m_pos - 1;
+  std::string_view::size_type last_char = std::string_view::npos;
+  std::string_view::size_type cur = 0;
   char last_c = -1;
   while (peek() != '\n' && peek() != -1 &&
          !((last_c == ' ' || last_c == '\t' || last_c == '\r') &&
@@ -164,25 +189,24 @@ std::string INIParser::get_value() {
     }
 
     last_c = static_cast<char>(peek());
-    str << last_c;
 
     next();
     cur += 1;
   }
 
-  if (last_char == std::string::npos) {
-    return str.str();
+  if (last_char == std::string_view::npos) {
+    return m_data.substr(start, cur);
   } else {
-    return str.str().substr(0, last_char + 1);
+    return m_data.substr(start, last_char + 1);
   }
 }
 
-std::string INIParser::get_ident() {
+std::string_view INIParser::get_ident() {
   // an unquoted value is terminated either by a newline or a comment
   // character, whitespace at the end of the value will be trimmed
-  std::ostringstream str;
-  std::string::size_type last_char = std::string::npos;
-  std::string::size_type cur = 0;
+  std::string_view::size_type const start = m_pos - 1;
+  std::string_view::size_type last_char = std::string_view::npos;
+  std::string_view::size_type cur = 0;
   char last_c = -1;
   while (peek() != '\n' && peek() != -1 && peek() != '=' &&
          !((last_c == ' ' || last_c == '\t' || last_c == '\r') &&
@@ -192,57 +216,56 @@ std::string INIParser::get_ident() {
     }
 
     last_c = static_cast<char>(peek());
-    str << last_c;
 
     next();
     cur += 1;
   }
 
-  if (last_char == std::string::npos) {
-    return str.str();
+  if (last_char == std::string_view::npos) {
+    return m_data.substr(start, cur);
   } else {
-    return str.str().substr(0, last_char + 1);
+    return m_data.substr(start, last_char + 1);
   }
 }
 
-std::string INIParser::get_string() {
+void INIParser::get_string(std::string* out) {
   // reads a string, handles escaping, does not eat begin and end quotes
-  std::ostringstream str;
+  out->clear();
   while (peek() != '"') {
     if (peek() == '\\') {
       next();
       switch (peek()) {
         case '\\':
-          str << '\\';
+          *out += '\\';
           break;
         case '0':
-          str << '\0';
+          *out += '\0';
           break;
         case 'a':
-          str << '\a';
+          *out += '\a';
           break;
         case 'b':
-          str << '\b';
+          *out += '\b';
           break;
         case 't':
-          str << '\t';
+          *out += '\t';
           break;
         case 'r':
-          str << '\r';
+          *out += '\r';
           break;
         case 'n':
-          str << '\n';
+          *out += '\n';
           break;
         default:
-          str << '\\' << static_cast<char>(peek());
+          *out += '\\';
+          *out += static_cast<char>(peek());
           break;
       }
     } else {
-      str << static_cast<char>(peek());
+      *out += static_cast<char>(peek());
     }
     next();
   }
-  return str.str();
 }
 
 void INIParser::newline() {
@@ -261,13 +284,12 @@ void INIParser::eat_rest_of_line() {
   }
 }
 
-std::string INIParser::get_section() {
-  std::ostringstream str;
+std::string_view INIParser::get_section() {
+  std::string_view::size_type const start = m_pos - 1;
   while (peek() != ']') {
-    str << static_cast<char>(peek());
     next();
   }
-  return str.str();
+  return m_data.substr(start, m_pos - 1 - start);
 }
 
 void INIParser::whitespace() {
@@ -276,6 +298,4 @@ void INIParser::whitespace() {
   }
 }
 
-int INIParser::getchar() { return m_in.get(); }
-
 /* EOF */
@@ -21,21 +21,37 @@
 
 #include <sstream>
 #include <string>
+#include <string_view>
 
 class INIBuilder;
 
+/** Single pass parser working on an in-memory buffer, unquoted names
+    and values are handed out as slices of the buffer and only copied
+    into reused scratch strings before being passed to the builder */
 class INIParser {
  private:
-  std::istream& m_in;
+  std::string m_buffer;
+  std::string_view m_data;
+  std::string_view::size_type m_pos;
+  bool m_eof;
+
   INIBuilder& m_builder;
   std::string m_context;
   int m_line;
   int m_column;
   int m_current_char;
 
+  std::string m_name;
+  std::string m_value;
+
  public:
+  /** Reads the whole stream into memory before parsing */
   INIParser(std::istream& in, INIBuilder& builder, const std::string& context);
 
+  /** Parses \a data directly, \a data must outlive the parser */
+  INIParser(std::string_view data, INIBuilder& builder,
+            const std::string& context);
+
   void run();
 
  private:
@@ -44,16 +60,15 @@ class INIParser {
   void next();
   bool accept(char c);
   void expect(char c);
-  std::string get_string();
-  std::string get_value();
-  std::string get_ident();
-  std::string get_value_or_string();
-  std::string get_ident_or_string();
+  void get_string(std::string* out);
+  std::string_view get_value();
+  std::string_view get_ident();
+  void get_value_or_string(std::string* out);
+  void get_ident_or_string(std::string* out);
   void newline();
   void eat_rest_of_line();
-  std::string get_section();
+  std::string_view get_section();
   void whitespace();
-  int getchar();
 
  private:
   INIParser(const INIParser&);
@@ -224,7 +224,7 @@ INISchemaSection& INISchemaSection::operator()(
   return *this;
 }
 
-INIPairSchema* INISchemaSection::get(const std::string& name) const {
+INIPairSchema* INISchemaSection::get(std::string_view name) const {
   Schema::const_iterator i = m_schema.find(name);
   if (i == m_schema.end()) {
     return 0;
@@ -263,7 +263,7 @@ INISchemaSection& INISchema::section(
   return *sec;
 }
 
-INISchemaSection* INISchema::get_section(const std::string& name) const {
+INISchemaSection* INISchema::get_section(std::string_view name) const {
   Sections::const_iterator i = m_sections.find(name);
   if (i != m_sections.end()) {
     return i->second;
@@ -22,6 +22,7 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <string_view>
 
 class INIPairSchema {
  public:
@@ -33,7 +34,7 @@ class INIPairSchema {
 
 class INISchemaSection {
  private:
-  typedef std::map<std::string, INIPairSchema*> Schema;
+  typedef std::map<std::string, INIPairSchema*, std::less<> > Schema;
   Schema m_schema;
 
  public:
@@ -55,7 +56,7 @@ class INISchemaSection {
                                std::function<void()> true_callback,
                                std::function<void()> false_callback);
 
-  INIPairSchema* get(const std::string& name) const;
+  INIPairSchema* get(std::string_view name) const;
 
   void save(std::ostream& out);
 
@@ -69,7 +70,7 @@ class INISchemaSection {
 
 class INISchema {
  private:
-  typedef std::map<std::string, INISchemaSection*> Sections;
+  typedef std::map<std::string, INISchemaSection*, std::less<> > Sections;
   Sections m_sections;
 
  public:
@@ -83,7 +84,7 @@ class INISchema {
       std::function<void(const std::string&, const std::string&)> callback =
           std::function<void(const std::string&, const std::string&)>());
 
-  INISchemaSection* get_section(const std::string& name) const;
+  INISchemaSection* get_section(std::string_view name) const;
 
   void save(std::ostream& out);
 
@@ -24,15 +24,19 @@
 #include "ini_schema.hpp"
 
 INISchemaBuilder::INISchemaBuilder(const INISchema& schema)
-    : m_schema(schema), m_current_section() {}
+    : m_schema(schema),
+      m_current_section(),
+      m_current_section_schema(m_schema.get_section(m_current_section)) {}
 
 void INISchemaBuilder::send_section(const std::string& section) {
+  // resolve the section once here instead of for every pair
   m_current_section = section;
+  m_current_section_schema = m_schema.get_section(m_current_section);
 }
 
 void INISchemaBuilder::send_pair(const std::string& name,
                                  const std::string& value) {
-  INISchemaSection* section = m_schema.get_section(m_current_section);
+  INISchemaSection* section = m_current_section_schema;
   if (!section) {
     throw std::runtime_error("unknown section: '" + m_current_section + "'");
   } else {
@@ -24,11 +24,13 @@
 #include "ini_builder.hpp"
 
 class INISchema;
+class INISchemaSection;
 
 class INISchemaBuilder : public INIBuilder {
  private:
   const INISchema& m_schema;
   std::string m_current_section;
+  INISchemaSection* m_current_section_schema;
 
  public:
   INISchemaBuilder(const INISchema& schema);
@@ -16,32 +16,31 @@
 **  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#ifndef HEADER_XBOXDRV_UI_KEY_EVENT_EMITTER_HPP
-#define HEADER_XBOXDRV_UI_KEY_EVENT_EMITTER_HPP
+#ifndef HEADER_XBOXDRV_INPUT_EVENT_SINK_HPP
+#define HEADER_XBOXDRV_INPUT_EVENT_SINK_HPP
 
-#include <memory>
+#include <linux/input.h>
 
-#include "ui_event_emitter.hpp"
-
-class UIKeyEventCollector;
-
-class UIKeyEventEmitter : public UIEventEmitter {
- private:
-  UIKeyEventCollector& m_collector;
-  bool m_value;
+#include <cstdint>
+#include <string>
 
+/** Receives the devices and events of LinuxUinput in place of
+    /dev/uinput, see LinuxUinput::set_sink() */
+class InputEventSink {
  public:
-  UIKeyEventEmitter(UIKeyEventCollector& collector);
+  virtual ~InputEventSink() {}
 
-  void send(int value);
+  /** Announces a new device, returns the id its events are sent
+      with */
+  virtual uint32_t add_device(const std::string& name,
+                              const struct input_id& id) = 0;
+  virtual void remove_device(uint32_t device) = 0;
 
- private:
-  UIKeyEventEmitter(const UIKeyEventEmitter&);
-  UIKeyEventEmitter& operator=(const UIKeyEventEmitter&);
+  /** Adds \a ev to the current frame of \a device, an EV_SYN
+      SYN_REPORT completes the frame */
+  virtual void send(uint32_t device, const struct input_event& ev) = 0;
 };
 
-typedef std::shared_ptr<UIKeyEventEmitter> UIKeyEventEmitterPtr;
-
 #endif
 
 /* EOF */
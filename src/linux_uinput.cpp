@@ -20,6 +20,11 @@
 
 #include <fcntl.h>
 
+extern "C" {
+#include <libudev.h>
+}
+
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <cstring>
@@ -30,22 +35,32 @@
 #include "controller.hpp"
 #include "evdev_helper.hpp"
 #include "force_feedback_handler.hpp"
+#include "helper.hpp"
+#include "input_event_sink.hpp"
 #include "raise_exception.hpp"
 
+std::shared_ptr<InputEventSink> LinuxUinput::s_sink;
+int64_t LinuxUinput::s_event_time = 0;
+
+void LinuxUinput::set_sink(std::shared_ptr<InputEventSink> sink) {
+  s_sink = sink;
+}
+
 LinuxUinput::LinuxUinput(DeviceType device_type, const std::string& name_,
                          const struct input_id& usbid_)
     : m_device_type(device_type),
       name(name_),
       usbid(usbid_),
       m_finished(false),
+      m_created(false),
       m_fd(-1),
+      m_sink(s_sink),
+      m_sink_device(0),
       m_io_channel(),
       m_source_id(),
-      user_dev(),
-      key_bit(false),
-      rel_bit(false),
-      abs_bit(false),
-      led_bit(false),
+      m_absinfo(),
+      m_sysname(),
+      m_devnodes(),
       m_ff_handler(0),
       m_controller(),
       needs_sync(true),
@@ -57,8 +72,31 @@ LinuxUinput::LinuxUinput(DeviceType device_type, const std::string& name_,
   std::fill_n(key_lst, KEY_CNT, false);
   std::fill_n(ff_lst, FF_CNT, false);
 
-  memset(&user_dev, 0, sizeof(uinput_user_dev));
+  memset(m_absinfo, 0, sizeof(m_absinfo));
+}
+
+LinuxUinput::~LinuxUinput() {
+  if (m_source_id) {
+    g_source_remove(m_source_id);
+  }
+
+  if (m_io_channel) {
+    g_io_channel_unref(m_io_channel);
+  }
+
+  if (m_fd >= 0) {
+    if (is_created()) {
+      ioctl(m_fd, UI_DEV_DESTROY);
+    }
+    close(m_fd);
+  }
 
+  if (m_sink && m_finished) {
+    m_sink->remove_device(m_sink_device);
+  }
+}
+
+void LinuxUinput::open_device() {
   // Open the input device
   const char* uinput_filename[] = {"/dev/input/uinput", "/dev/uinput",
                                    "/dev/misc/uinput"};
@@ -94,13 +132,6 @@ LinuxUinput::LinuxUinput(DeviceType device_type, const std::string& name_,
   }
 }
 
-LinuxUinput::~LinuxUinput() {
-  g_source_remove(m_source_id);
-
-  ioctl(m_fd, UI_DEV_DESTROY);
-  close(m_fd);
-}
-
 void LinuxUinput::add_abs(uint16_t code, int min, int max, int fuzz, int flat) {
   log_debug("add_abs: " << abs2str(code) << " (" << min << ", " << max << ") "
                         << name);
@@ -108,56 +139,26 @@ void LinuxUinput::add_abs(uint16_t code, int min, int max, int fuzz, int flat) {
   if (!abs_lst[code]) {
     abs_lst[code] = true;
 
-    if (!abs_bit) {
-      ioctl(m_fd, UI_SET_EVBIT, EV_ABS);
-      abs_bit = true;
-    }
-
-    ioctl(m_fd, UI_SET_ABSBIT, code);
-
-    user_dev.absmin[code] = min;
-    user_dev.absmax[code] = max;
-    user_dev.absfuzz[code] = fuzz;
-    user_dev.absflat[code] = flat;
+    m_absinfo[code].minimum = min;
+    m_absinfo[code].maximum = max;
+    m_absinfo[code].fuzz = fuzz;
+    m_absinfo[code].flat = flat;
   }
 }
 
 void LinuxUinput::add_rel(uint16_t code) {
   log_debug("add_rel: " << rel2str(code) << " " << name);
 
-  if (!rel_lst[code]) {
-    rel_lst[code] = true;
-
-    if (!rel_bit) {
-      ioctl(m_fd, UI_SET_EVBIT, EV_REL);
-      rel_bit = true;
-    }
-
-    ioctl(m_fd, UI_SET_RELBIT, code);
-  }
+  rel_lst[code] = true;
 }
 
 void LinuxUinput::add_key(uint16_t code) {
   log_debug("add_key: " << key2str(code) << " " << name);
 
-  if (!key_lst[code]) {
-    key_lst[code] = true;
-
-    if (!key_bit) {
-      ioctl(m_fd, UI_SET_EVBIT, EV_KEY);
-      key_bit = true;
-    }
-
-    ioctl(m_fd, UI_SET_KEYBIT, code);
-  }
+  key_lst[code] = true;
 }
 
-void LinuxUinput::add_ff(uint16_t code) {
-  if (!ff_lst[code]) {
-    ff_lst[code] = true;
-    ioctl(m_fd, UI_SET_FFBIT, code);
-  }
-}
+void LinuxUinput::add_ff(uint16_t code) { ff_lst[code] = true; }
 
 void LinuxUinput::set_controller(Controller* controller) {
   m_controller = controller;
@@ -168,7 +169,6 @@ void LinuxUinput::enable_force_feedback() {
   assert(m_ff_handler == NULL);
   m_force_feedback_enabled = true;
 
-  ioctl(m_fd, UI_SET_EVBIT, EV_FF);
   m_ff_handler = new ForceFeedbackHandler(m_controller);
 }
 
@@ -177,9 +177,7 @@ void LinuxUinput::set_ff_gain(int gain) {
   m_ff_handler->set_gain(gain);
 }
 
-void LinuxUinput::finish() {
-  assert(!m_finished);
-
+void LinuxUinput::add_required_events() {
   // Create some mandatory events that are needed for the kernel/Xorg
   // to register the device as its proper type
   switch (m_device_type) {
@@ -215,50 +213,65 @@ void LinuxUinput::finish() {
   }
 
   if (m_force_feedback_enabled) {
-    log_debug("force-feedback is enabled in LinuxUinput");
-
     for (int i = 0; i < m_controller->get_ff_features().size(); ++i) {
       add_ff(m_controller->get_ff_features()[i]);
     }
   }
+}
 
-  strncpy(user_dev.name, name.c_str(), UINPUT_MAX_NAME_SIZE);
-  user_dev.id.version = usbid.version;
-  user_dev.id.bustype = usbid.bustype;
-  user_dev.id.vendor = usbid.vendor;
-  user_dev.id.product = usbid.product;
-
-  log_debug("'" << user_dev.name << "' " << user_dev.id.vendor << ":"
-                << user_dev.id.product);
-
-  if (m_force_feedback_enabled) {
-    user_dev.ff_effects_max = m_controller->get_num_ff_effects();
+bool LinuxUinput::has_same_capabilities(const LinuxUinput& other) const {
+  if (m_device_type != other.m_device_type || name != other.name ||
+      usbid.bustype != other.usbid.bustype ||
+      usbid.vendor != other.usbid.vendor ||
+      usbid.product != other.usbid.product ||
+      usbid.version != other.usbid.version ||
+      m_force_feedback_enabled != other.m_force_feedback_enabled) {
+    return false;
+  } else if (!std::equal(rel_lst, rel_lst + REL_CNT, other.rel_lst) ||
+             !std::equal(key_lst, key_lst + KEY_CNT, other.key_lst) ||
+             !std::equal(abs_lst, abs_lst + ABS_CNT, other.abs_lst) ||
+             !std::equal(ff_lst, ff_lst + FF_CNT, other.ff_lst)) {
+    return false;
+  } else {
+    for (int code = 0; code < ABS_CNT; ++code) {
+      if (abs_lst[code] &&
+          (m_absinfo[code].minimum != other.m_absinfo[code].minimum ||
+           m_absinfo[code].maximum != other.m_absinfo[code].maximum ||
+           m_absinfo[code].fuzz != other.m_absinfo[code].fuzz ||
+           m_absinfo[code].flat != other.m_absinfo[code].flat)) {
+        return false;
+      }
+    }
+    return true;
   }
+}
 
-  {
-    int write_ret = write(m_fd, &user_dev, sizeof(user_dev));
-    if (write_ret < 0) {
-      throw std::runtime_error("uinput:finish: " + name + ": " +
-                               strerror(errno));
-    } else {
-      log_debug("write return value: " << write_ret);
-    }
+void LinuxUinput::finish() {
+  start();
+  if (!is_created()) {
+    create();
   }
+}
 
-  // FIXME: check that the config isn't empty and give a more
-  // meaningful message when it is
+void LinuxUinput::start() {
+  assert(!m_finished);
 
-  log_debug("finish");
-  if (ioctl(m_fd, UI_DEV_CREATE)) {
-    raise_exception(std::runtime_error, "unable to create uinput device: '"
-                                            << name
-                                            << "': " << strerror(errno));
+  add_required_events();
+
+  if (m_sink) {
+    // force feedback needs the kernel, so there is none without it
+    m_sink_device = m_sink->add_device(name, usbid);
+    m_finished = true;
+    m_created.store(true, std::memory_order_release);
+    return;
   }
 
+  open_device();
+
   m_finished = true;
 
   {
-    // start g_io_channel
+    // start g_io_channel, nothing can be read before create() is done
     m_io_channel = g_io_channel_unix_new(m_fd);
 
     // set encoding to binary
@@ -277,13 +290,162 @@ void LinuxUinput::finish() {
   }
 }
 
+void LinuxUinput::create() {
+  assert(m_finished && !is_created());
+
+  // the events are only handed to the kernel here, so that a device
+  // that gets replaced before finish() never touches /dev/uinput
+  if (std::find(abs_lst, abs_lst + ABS_CNT, true) != abs_lst + ABS_CNT) {
+    ioctl(m_fd, UI_SET_EVBIT, EV_ABS);
+    for (int code = 0; code < ABS_CNT; ++code) {
+      if (abs_lst[code]) {
+        struct uinput_abs_setup abs_setup;
+        memset(&abs_setup, 0, sizeof(abs_setup));
+        abs_setup.code = code;
+        abs_setup.absinfo = m_absinfo[code];
+
+        // also sets the ABS bit
+        if (ioctl(m_fd, UI_ABS_SETUP, &abs_setup) < 0) {
+          raise_exception(std::runtime_error, "UI_ABS_SETUP failed: '"
+                                                  << name << "': "
+                                                  << strerror(errno));
+        }
+      }
+    }
+  }
+
+  if (std::find(rel_lst, rel_lst + REL_CNT, true) != rel_lst + REL_CNT) {
+    ioctl(m_fd, UI_SET_EVBIT, EV_REL);
+    for (int code = 0; code < REL_CNT; ++code) {
+      if (rel_lst[code]) ioctl(m_fd, UI_SET_RELBIT, code);
+    }
+  }
+
+  if (std::find(key_lst, key_lst + KEY_CNT, true) != key_lst + KEY_CNT) {
+    ioctl(m_fd, UI_SET_EVBIT, EV_KEY);
+    for (int code = 0; code < KEY_CNT; ++code) {
+      if (key_lst[code]) ioctl(m_fd, UI_SET_KEYBIT, code);
+    }
+  }
+
+  if (m_force_feedback_enabled) {
+    log_debug("force-feedback is enabled in LinuxUinput");
+
+    ioctl(m_fd, UI_SET_EVBIT, EV_FF);
+    for (int code = 0; code < FF_CNT; ++code) {
+      if (ff_lst[code]) ioctl(m_fd, UI_SET_FFBIT, code);
+    }
+  }
+
+  struct uinput_setup setup;
+  memset(&setup, 0, sizeof(setup));
+  strncpy(setup.name, name.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+  setup.id = usbid;
+
+  log_debug("'" << setup.name << "' " << setup.id.vendor << ":"
+                << setup.id.product);
+
+  if (m_force_feedback_enabled) {
+    setup.ff_effects_max = m_controller->get_num_ff_effects();
+  }
+
+  if (ioctl(m_fd, UI_DEV_SETUP, &setup) < 0) {
+    raise_exception(std::runtime_error, "UI_DEV_SETUP failed: '"
+                                            << name
+                                            << "': " << strerror(errno));
+  }
+
+  // FIXME: check that the config isn't empty and give a more
+  // meaningful message when it is
+
+  log_debug("finish");
+  if (ioctl(m_fd, UI_DEV_CREATE)) {
+    raise_exception(std::runtime_error, "unable to create uinput device: '"
+                                            << name
+                                            << "': " << strerror(errno));
+  }
+
+  resolve_devnodes();
+
+  m_created.store(true, std::memory_order_release);
+}
+
+const std::vector<std::string>& LinuxUinput::get_devnodes() const {
+  static const std::vector<std::string> empty;
+
+  // m_devnodes is only written by create()
+  return is_created() ? m_devnodes : empty;
+}
+
+void LinuxUinput::resolve_devnodes() {
+  // the evdev and joydev nodes are registered within UI_DEV_CREATE,
+  // so they can be read back right away instead of being guessed
+  char sysname[64];
+  if (ioctl(m_fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0) {
+    log_warn("UI_GET_SYSNAME failed, device nodes unknown: "
+             << name << ": " << strerror(errno));
+    return;
+  }
+  m_sysname = sysname;
+
+  udev* ud = udev_new();
+  if (!ud) {
+    log_warn("udev_new() failed, device nodes unknown: " << name);
+    return;
+  }
+
+  udev_device* device =
+      udev_device_new_from_subsystem_sysname(ud, "input", m_sysname.c_str());
+  if (!device) {
+    log_warn("couldn't find " << m_sysname << " in udev: " << name);
+  } else {
+    udev_enumerate* enumerate = udev_enumerate_new(ud);
+    udev_enumerate_add_match_parent(enumerate, device);
+    udev_enumerate_scan_devices(enumerate);
+
+    udev_list_entry* entry;
+    udev_list_entry_foreach(entry,
+                            udev_enumerate_get_list_entry(enumerate)) {
+      udev_device* child =
+          udev_device_new_from_syspath(ud, udev_list_entry_get_name(entry));
+      if (child) {
+        const char* devnode = udev_device_get_devnode(child);
+        if (devnode) {
+          m_devnodes.push_back(devnode);
+        }
+        udev_device_unref(child);
+      }
+    }
+
+    udev_enumerate_unref(enumerate);
+    udev_device_unref(device);
+  }
+
+  udev_unref(ud);
+
+  std::sort(m_devnodes.begin(), m_devnodes.end());
+  for (std::vector<std::string>::iterator i = m_devnodes.begin();
+       i != m_devnodes.end(); ++i) {
+    log_debug(name << ": " << m_sysname << ": " << *i);
+  }
+}
+
 void LinuxUinput::send(uint16_t type, uint16_t code, int32_t value) {
+  if (!is_created()) {
+    // still being created, so there is nobody who could read it
+    return;
+  }
+
   needs_sync = true;
 
   struct input_event ev;
   memset(&ev, 0, sizeof(ev));
 
-  gettimeofday(&ev.time, NULL);
+  // the kernel restamps events written to uinput, but a sink passes
+  // the time the input happened on
+  int64_t time = s_event_time ? s_event_time : get_time_nsec();
+  ev.time.tv_sec = static_cast<time_t>(time / 1000000000);
+  ev.time.tv_usec = static_cast<suseconds_t>(time % 1000000000 / 1000);
   ev.type = type;
   ev.code = code;
   if (ev.type == EV_KEY)
@@ -291,7 +453,9 @@ void LinuxUinput::send(uint16_t type, uint16_t code, int32_t value) {
   else
     ev.value = value;
 
-  if (write(m_fd, &ev, sizeof(ev)) < 0)
+  if (m_sink)
+    m_sink->send(m_sink_device, ev);
+  else if (write(m_fd, &ev, sizeof(ev)) < 0)
     throw std::runtime_error(std::string("uinput:send_button: ") +
                              strerror(errno));
 }
@@ -22,12 +22,16 @@
 #include <glib.h>
 #include <linux/uinput.h>
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 class ForceFeedbackHandler;
 class Controller;
+class InputEventSink;
 
 class LinuxUinput {
  public:
@@ -38,22 +42,38 @@ class LinuxUinput {
     kJoystickDevice
   };
 
+  /** Makes devices created from now on send their events to \a sink
+      instead of creating a device in the kernel */
+  static void set_sink(std::shared_ptr<InputEventSink> sink);
+
+  /** Sets the CLOCK_MONOTONIC nsec that events sent from now on are
+      stamped with, 0 stamps them with the current time */
+  static void set_event_time(int64_t time) { s_event_time = time; }
+
  private:
+  static std::shared_ptr<InputEventSink> s_sink;
+  static int64_t s_event_time;
+
   DeviceType m_device_type;
   std::string name;
   struct input_id usbid;
 
   bool m_finished;
+  /** set once the device exists in the kernel, create() might run in
+      another thread */
+  std::atomic<bool> m_created;
 
   int m_fd;
+  std::shared_ptr<InputEventSink> m_sink;
+  uint32_t m_sink_device;
   GIOChannel* m_io_channel;
   guint m_source_id;
 
-  uinput_user_dev user_dev;
-  bool key_bit;
-  bool rel_bit;
-  bool abs_bit;
-  bool led_bit;
+  struct input_absinfo m_absinfo[ABS_CNT];
+
+  /** set by finish() from UI_GET_SYSNAME, e.g. "input42" */
+  std::string m_sysname;
+  std::vector<std::string> m_devnodes;
 
   bool abs_lst[ABS_CNT];
   bool rel_lst[REL_CNT];
@@ -87,10 +107,35 @@ class LinuxUinput {
   void enable_force_feedback();
   void set_ff_gain(int gain);
 
-  /** Finalized the device creation */
+  /** Adds the events the kernel and Xorg need to detect the device
+      as its DeviceType, called by finish() */
+  void add_required_events();
+
+  /** Finalized the device creation, same as start() followed by
+      create() */
   void finish();
+  bool is_finished() const { return m_finished; }
+
+  /** Opens /dev/uinput and hooks it into the main loop, the device
+      doesn't exist in the kernel yet and events sent to it are
+      dropped until create() is done */
+  void start();
+
+  /** Creates the device in the kernel, this is the slow part and
+      may run in any thread after start() */
+  void create();
+  bool is_created() const { return m_created.load(std::memory_order_acquire); }
   /*@}*/
 
+  /** The nodes the kernel created for this device, e.g.
+      /dev/input/event12 and /dev/input/js3, empty before create() or
+      when events go to a sink */
+  const std::vector<std::string>& get_devnodes() const;
+
+  /** Returns true when \a other was set up with the same name, id and
+      events, so that it can stand in for this device */
+  bool has_same_capabilities(const LinuxUinput& other) const;
+
   void send(uint16_t type, uint16_t code, int32_t value);
 
   /** Sends out a sync event if there is a need for it. */
@@ -99,6 +144,11 @@ class LinuxUinput {
   void update(int msec_delta);
 
  private:
+  void open_device();
+
+  /** looks up the nodes of the just created device via its sysname */
+  void resolve_devnodes();
+
   gboolean on_read_data(GIOChannel* source, GIOCondition condition);
   static gboolean on_read_data_wrap(GIOChannel* source, GIOCondition condition,
                                     gpointer userdata) {
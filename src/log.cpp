@@ -18,26 +18,167 @@
 
 #include "log.hpp"
 
+#include <pthread.h>
+
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <new>
 #include <string>
 
+#include "ring_buffer.hpp"
+#include "scheduling.hpp"
+
 Logger g_logger;
 
-std::string log_pretty_print(const std::string& str) {
-  // FIXME: very basic, might not work with complex return types
-  std::string::size_type function_start = 0;
-  for (std::string::size_type i = 0; i < str.size(); ++i) {
-    if (str[i] == ' ') {
-      function_start = i + 1;
-    } else if (str[i] == '(') {
-      return str.substr(function_start, i - function_start) + "()";
+namespace {
+
+const size_t kQueueSize = 64 * 1024;
+
+struct RecordHeader {
+  Logger::LogLevel level;
+  const char* function;
+  uint32_t function_len;
+  uint32_t text_len;
+};
+
+const char* level_prefix(Logger::LogLevel level) {
+  switch (level) {
+    case Logger::kError:
+      return "[ERROR] ";
+    case Logger::kWarning:
+      return "[WARN]  ";
+    case Logger::kInfo:
+      return "[INFO]  ";
+    case Logger::kDebug:
+      return "[DEBUG] ";
+    case Logger::kTemp:
+      return "[TEMP]  ";
+  }
+  return "";
+}
+
+int64_t now_msec() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+/** The queue of a single thread, it stays registered with the Logger
+    until it is drained after the thread exited */
+class Logger::Queue {
+ public:
+  RingBuffer ring;
+  std::atomic<bool> orphaned;
+
+  Queue() : ring(kQueueSize), orphaned(false) {}
+};
+
+namespace {
+
+// set once the thread local state of this thread is destroyed, a bool
+// stays readable after that
+thread_local bool t_exiting = false;
+
+// the stream handed out by LogStream
+struct StreamHolder {
+  std::ostringstream* stream;
+  bool in_use;
+
+  StreamHolder() : stream(new std::ostringstream), in_use(false) {}
+  ~StreamHolder() {
+    t_exiting = true;
+    delete stream;
+  }
+};
+
+thread_local StreamHolder t_stream;
+
+struct QueueHandle {
+  std::shared_ptr<Logger::Queue> queue;
+
+  QueueHandle() : queue() {}
+  ~QueueHandle() {
+    t_exiting = true;
+    if (queue) {
+      queue->orphaned = true;
     }
   }
+};
+
+thread_local QueueHandle t_queue;
+thread_local std::string t_record;
+
+}  // namespace
+
+std::string log_pretty_print(const std::string& str) {
+  return std::string(log_function_name(str)) + "()";
+}
+
+bool LogRateLimit::allow(int* suppressed) {
+  int64_t now = now_msec();
+  if (now - m_window_start >= kWindowMsec) {
+    m_window_start = now;
+    m_count = 0;
+  }
 
-  return str.substr(function_start);
+  if (m_count.fetch_add(1) < kBurst) {
+    *suppressed = m_suppressed.exchange(0);
+    return true;
+  } else {
+    m_suppressed += 1;
+    return false;
+  }
+}
+
+LogStream::LogStream() : m_stream(), m_fallback() {
+  if (t_exiting || t_stream.in_use) {
+    m_fallback.reset(new std::ostringstream);
+    m_stream = m_fallback.get();
+  } else {
+    t_stream.in_use = true;
+    m_stream = t_stream.stream;
+    m_stream->str(std::string());
+    m_stream->clear();
+  }
 }
 
-Logger::Logger() : m_log_level(kWarning) {}
+LogStream::~LogStream() {
+  if (!m_fallback) {
+    t_stream.in_use = false;
+  }
+}
+
+Logger::Logger()
+    : m_log_level(kWarning),
+      m_mutex(),
+      m_cond(),
+      m_queues(),
+      m_thread(),
+      m_quit(false),
+      m_writing(false),
+      m_queued(false),
+      m_shutdown(false),
+      m_dropped(0) {
+  pthread_atfork(&Logger::on_fork_prepare, &Logger::on_fork_parent,
+                 &Logger::on_fork_child);
+}
+
+Logger::~Logger() {
+  if (m_thread) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_quit = true;
+    }
+    m_cond.notify_one();
+    m_thread->join();
+  }
+
+  // whatever gets logged from here on is written directly
+  m_shutdown = true;
+}
 
 void Logger::incr_log_level(LogLevel level) {
   if (get_log_level() < level) {
@@ -50,25 +191,45 @@ void Logger::set_log_level(LogLevel level) { m_log_level = level; }
 Logger::LogLevel Logger::get_log_level() const { return m_log_level; }
 
 void Logger::append_unchecked(LogLevel level, const std::string& str) {
-  switch (level) {
-    case kError:
-      std::cout << "[ERROR] ";
-      break;
-    case kWarning:
-      std::cout << "[WARN]  ";
-      break;
-    case kInfo:
-      std::cout << "[INFO]  ";
-      break;
-    case kDebug:
-      std::cout << "[DEBUG] ";
-      break;
-    case kTemp:
-      std::cout << "[TEMP]  ";
-      break;
-  }
-
-  std::cout << str << std::endl;
+  append_unchecked(level, std::string_view(), str);
+}
+
+void Logger::append_unchecked(LogLevel level, std::string_view function,
+                              std::string_view str) {
+  if (m_shutdown || t_exiting) {
+    write_record(level, function, str);
+    std::cout.flush();
+    return;
+  }
+
+  RecordHeader header;
+  header.level = level;
+  header.function = function.data();
+  header.function_len = static_cast<uint32_t>(function.size());
+  header.text_len = static_cast<uint32_t>(str.size());
+
+  // assemble the record first, so that the writer never sees half of
+  // it
+  t_record.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+  t_record.append(str);
+
+  Queue& queue = get_queue();
+  if (queue.ring.write_available() < t_record.size()) {
+    m_dropped += 1;
+  } else {
+    queue.ring.write(reinterpret_cast<const uint8_t*>(t_record.data()),
+                     t_record.size());
+
+    // only the first message after the writer went to sleep has to
+    // wake it, passing through the mutex orders the flag before its
+    // wait
+    if (!m_queued.exchange(true)) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+      }
+      m_cond.notify_one();
+    }
+  }
 }
 
 void Logger::append(LogLevel level, const std::string& str) {
@@ -77,4 +238,147 @@ void Logger::append(LogLevel level, const std::string& str) {
   }
 }
 
+void Logger::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_thread) {
+    while (true) {
+      bool empty = !m_writing;
+      for (std::vector<std::shared_ptr<Queue> >::iterator i = m_queues.begin();
+           i != m_queues.end(); ++i) {
+        if ((*i)->ring.read_available() != 0) {
+          empty = false;
+        }
+      }
+
+      if (empty) {
+        break;
+      } else {
+        m_cond.notify_one();
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        lock.lock();
+      }
+    }
+  }
+}
+
+Logger::Queue& Logger::get_queue() {
+  if (!t_queue.queue) {
+    t_queue.queue.reset(new Queue);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queues.push_back(t_queue.queue);
+    if (!m_thread) {
+      m_thread.reset(new std::thread(&Logger::run, this));
+    }
+  }
+  return *t_queue.queue;
+}
+
+void Logger::run() {
+  setup_helper_thread_scheduling();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    // cleared before writing, whatever comes in meanwhile sets it
+    // again, the exchange also makes the queued records visible
+    m_queued.exchange(false);
+
+    lock.unlock();
+    bool busy = write_pending();
+    lock.lock();
+
+    if (!busy) {
+      if (m_quit) {
+        break;
+      } else {
+        m_cond.wait(lock, [this] { return m_quit || m_queued; });
+      }
+    }
+  }
+}
+
+bool Logger::write_pending() {
+  m_writing = true;
+
+  std::vector<std::shared_ptr<Queue> > queues;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // forget about queues of threads that are gone and fully drained
+    for (std::vector<std::shared_ptr<Queue> >::iterator i = m_queues.begin();
+         i != m_queues.end();) {
+      if ((*i)->orphaned && (*i)->ring.read_available() == 0) {
+        i = m_queues.erase(i);
+      } else {
+        ++i;
+      }
+    }
+    queues = m_queues;
+  }
+
+  bool busy = false;
+  std::string text;
+  for (std::vector<std::shared_ptr<Queue> >::iterator i = queues.begin();
+       i != queues.end(); ++i) {
+    RingBuffer& ring = (*i)->ring;
+    while (ring.read_available() >= sizeof(RecordHeader)) {
+      RecordHeader header;
+      ring.read(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+      text.resize(header.text_len);
+      ring.read(reinterpret_cast<uint8_t*>(&text[0]), header.text_len);
+
+      write_record(header.level,
+                   std::string_view(header.function, header.function_len),
+                   text);
+      busy = true;
+    }
+  }
+
+  unsigned int dropped = m_dropped.exchange(0);
+  if (dropped) {
+    std::cout << level_prefix(kWarning) << dropped
+              << " log messages dropped, the log queue was full\n";
+  }
+
+  if (busy) {
+    std::cout.flush();
+  }
+
+  m_writing = false;
+  return busy;
+}
+
+void Logger::write_record(LogLevel level, std::string_view function,
+                          std::string_view text) {
+  // build the whole line first, so that it goes out in one piece
+  std::string line = level_prefix(level);
+  if (!function.empty()) {
+    line.append(function);
+    line += "()";
+    if (!text.empty()) {
+      line += ": ";
+    }
+  }
+  line.append(text);
+  line += '\n';
+  std::cout << line;
+}
+
+void Logger::on_fork_prepare() { g_logger.m_mutex.lock(); }
+
+void Logger::on_fork_parent() { g_logger.m_mutex.unlock(); }
+
+void Logger::on_fork_child() {
+  // the writer thread doesn't exist in the child and the queued
+  // messages are the parent's to write, start over, the condition
+  // variable still counts the writer as a waiter, so it is recreated
+  g_logger.m_mutex.unlock();
+  new (&g_logger.m_cond) std::condition_variable;
+  g_logger.m_thread.release();
+  g_logger.m_queues.clear();
+  g_logger.m_writing = false;
+  g_logger.m_queued = false;
+  t_queue.queue.reset();
+}
+
 /* EOF */
@@ -19,13 +19,81 @@
 #ifndef HEADER_XBOXDRV_LOG_HPP
 #define HEADER_XBOXDRV_LOG_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/** Takes __PRETTY_FUNCTION__ and shortens it to the form
+    Classname::function, at compile time */
+constexpr std::string_view log_function_name(std::string_view str) {
+  // FIXME: very basic, might not work with complex return types
+  std::string_view::size_type function_start = 0;
+  for (std::string_view::size_type i = 0; i < str.size(); ++i) {
+    if (str[i] == ' ') {
+      function_start = i + 1;
+    } else if (str[i] == '(') {
+      return str.substr(function_start, i - function_start);
+    }
+  }
+
+  return str.substr(function_start);
+}
 
 /** Takes __PRETTY_FUNCTION__ and tries to shorten it to the form:
     Classname::function() */
 std::string log_pretty_print(const std::string& str);
 
+/** Limits a single log statement to a burst of messages per second,
+    so that a failure repeating at the polling rate doesn't flood the
+    log */
+class LogRateLimit {
+ private:
+  static const int kBurst = 10;
+  static const int kWindowMsec = 1000;
+
+  std::atomic<int64_t> m_window_start;
+  std::atomic<int> m_count;
+  std::atomic<int> m_suppressed;
+
+ public:
+  LogRateLimit() : m_window_start(0), m_count(0), m_suppressed(0) {}
+
+  /** Returns false if the message should be dropped, otherwise
+      \a suppressed is set to the number of messages dropped since
+      the last one that got through */
+  bool allow(int* suppressed);
+};
+
+/** Hands out a cleared thread local stream to format a message into,
+    so that logging doesn't construct a std::ostringstream every time,
+    nested use falls back to a fresh stream */
+class LogStream {
+ private:
+  std::ostringstream* m_stream;
+  std::unique_ptr<std::ostringstream> m_fallback;
+
+ public:
+  LogStream();
+  ~LogStream();
+
+  std::ostream& get() { return *m_stream; }
+  std::string_view view() const { return m_stream->view(); }
+
+ private:
+  LogStream(const LogStream&);
+  LogStream& operator=(const LogStream&);
+};
+
+/** Messages are put into a lock-free ring buffer of the calling
+    thread, a background thread formats and writes them to stdout, so
+    logging from a USB callback doesn't wait for the terminal */
 class Logger {
  public:
   enum LogLevel {
@@ -47,74 +115,103 @@ class Logger {
     kTemp
   };
 
+  class Queue;
+
  private:
   LogLevel m_log_level;
 
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::vector<std::shared_ptr<Queue> > m_queues;
+  std::unique_ptr<std::thread> m_thread;
+  bool m_quit;
+  std::atomic<bool> m_writing;
+  /** set by producers, so that the writer doesn't miss a message
+      that arrives while it is about to wait */
+  std::atomic<bool> m_queued;
+  std::atomic<bool> m_shutdown;
+  std::atomic<unsigned int> m_dropped;
+
  public:
   Logger();
+  ~Logger();
+
   void incr_log_level(LogLevel level);
   void set_log_level(LogLevel level);
   LogLevel get_log_level() const;
   void append(LogLevel level, const std::string& str);
   void append_unchecked(LogLevel level, const std::string& str);
+  void append_unchecked(LogLevel level, std::string_view function,
+                        std::string_view str);
+
+  /** Blocks until all messages logged so far have been written */
+  void flush();
+
+ private:
+  Queue& get_queue();
+  void run();
+  bool write_pending();
+  static void write_record(LogLevel level, std::string_view function,
+                           std::string_view text);
+
+  static void on_fork_prepare();
+  static void on_fork_parent();
+  static void on_fork_child();
+
+ private:
+  Logger(const Logger&);
+  Logger& operator=(const Logger&);
 };
 
-#define log_debug(text)                                                   \
-  do {                                                                    \
-    if (g_logger.get_log_level() >= Logger::kDebug) {                     \
-      std::ostringstream x6ac1c382;                                       \
-      x6ac1c382 << log_pretty_print(__PRETTY_FUNCTION__) << ": " << text; \
-      g_logger.append_unchecked(Logger::kDebug, x6ac1c382.str());         \
-    }                                                                     \
+#define log_message_unchecked(level, text)                 \
+  do {                                                     \
+    static constexpr std::string_view x6ac1c382_function = \
+        log_function_name(__PRETTY_FUNCTION__);            \
+    LogStream x6ac1c382;                                   \
+    x6ac1c382.get() << text;                               \
+    g_logger.append_unchecked(level, x6ac1c382_function,   \
+                              x6ac1c382.view());           \
   } while (false)
 
-#define log_info(text)                                                    \
-  do {                                                                    \
-    if (g_logger.get_log_level() >= Logger::kInfo) {                      \
-      std::ostringstream x6ac1c382;                                       \
-      x6ac1c382 << log_pretty_print(__PRETTY_FUNCTION__) << ": " << text; \
-      g_logger.append_unchecked(Logger::kInfo, x6ac1c382.str());          \
-    }                                                                     \
+#define log_message(level, text)             \
+  do {                                       \
+    if (g_logger.get_log_level() >= level) { \
+      log_message_unchecked(level, text);    \
+    }                                        \
   } while (false)
 
-#define log_warn(text)                                                    \
+#define log_message_limited(level, text)                                  \
   do {                                                                    \
-    if (g_logger.get_log_level() >= Logger::kWarning) {                   \
-      std::ostringstream x6ac1c382;                                       \
-      x6ac1c382 << log_pretty_print(__PRETTY_FUNCTION__) << ": " << text; \
-      g_logger.append_unchecked(Logger::kWarning, x6ac1c382.str());       \
+    if (g_logger.get_log_level() >= level) {                              \
+      static LogRateLimit x6ac1c382_limit;                                \
+      int x6ac1c382_suppressed;                                           \
+      if (x6ac1c382_limit.allow(&x6ac1c382_suppressed)) {                 \
+        if (x6ac1c382_suppressed) {                                       \
+          log_message_unchecked(level,                                    \
+                                text << " (" << x6ac1c382_suppressed      \
+                                     << " similar messages suppressed)"); \
+        } else {                                                          \
+          log_message_unchecked(level, text);                             \
+        }                                                                 \
+      }                                                                   \
     }                                                                     \
   } while (false)
 
-#define log_error(text)                                                   \
-  do {                                                                    \
-    if (g_logger.get_log_level() >= Logger::kError) {                     \
-      std::ostringstream x6ac1c382;                                       \
-      x6ac1c382 << log_pretty_print(__PRETTY_FUNCTION__) << ": " << text; \
-      g_logger.append_unchecked(Logger::kError, x6ac1c382.str());         \
-    }                                                                     \
-  } while (false)
+#define log_debug(text) log_message(Logger::kDebug, text)
+#define log_info(text) log_message(Logger::kInfo, text)
+#define log_warn(text) log_message_limited(Logger::kWarning, text)
+#define log_error(text) log_message_limited(Logger::kError, text)
 
 /** Write an empty debug message, thus only class and function
     name are visible, log level is ignored, messages are always
     printed. Use for temporary messages in development that should not
     be part of final release. */
-#define log_tmp_trace()                                        \
-  do {                                                         \
-    std::ostringstream x6ac1c382;                              \
-    x6ac1c382 << log_pretty_print(__PRETTY_FUNCTION__);        \
-    g_logger.append_unchecked(Logger::kTemp, x6ac1c382.str()); \
-  } while (false)
+#define log_tmp_trace() log_message_unchecked(Logger::kTemp, "")
 
 /** Write an debug message, while ignoring the log level. Use for
     temporary messages in development that should not be part of final
     release. */
-#define log_tmp(text)                                                   \
-  do {                                                                  \
-    std::ostringstream x6ac1c382;                                       \
-    x6ac1c382 << log_pretty_print(__PRETTY_FUNCTION__) << ": " << text; \
-    g_logger.append_unchecked(Logger::kTemp, x6ac1c382.str());          \
-  } while (false)
+#define log_tmp(text) log_message_unchecked(Logger::kTemp, text)
 
 extern Logger g_logger;
 
@@ -0,0 +1,168 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "macro_engine.hpp"
+
+#include <cassert>
+
+#include "uinput.hpp"
+
+MacroEngine::Instance::Instance()
+    : m_engine(0),
+      m_program(0),
+      m_uinput(0),
+      m_pc(0),
+      m_counters(),
+      m_held(false),
+      m_running(false) {}
+
+MacroEngine::Instance::~Instance() {
+  if (m_engine) {
+    m_engine->stop(*this);
+  }
+}
+
+void MacroEngine::Instance::expire(uint64_t now) {
+  // continue from the deadline, not from when we got woken up
+  m_engine->run(*this, get_deadline());
+}
+
+MacroEngine& MacroEngine::current() {
+  static MacroEngine engine;
+  return engine;
+}
+
+MacroEngine::MacroEngine()
+    : m_wheel(get_ticks()), m_source_funcs(), m_source() {
+  // the source does nothing but wake up at its ready time
+  m_source_funcs.prepare = NULL;
+  m_source_funcs.check = NULL;
+  m_source_funcs.dispatch = &MacroEngine::on_source_dispatch;
+  m_source_funcs.finalize = NULL;
+
+  m_source = g_source_new(&m_source_funcs, sizeof(GSource));
+  g_source_set_callback(m_source, &MacroEngine::on_source_wrap, this, NULL);
+  g_source_set_ready_time(m_source, -1);
+  g_source_attach(m_source, NULL);
+}
+
+MacroEngine::~MacroEngine() {
+  g_source_destroy(m_source);
+  g_source_unref(m_source);
+}
+
+uint64_t MacroEngine::get_ticks() {
+  return static_cast<uint64_t>(g_get_monotonic_time()) /
+         MacroProgram::kTickUsec;
+}
+
+void MacroEngine::start(Instance& instance, const MacroProgram& program,
+                        UInput& uinput) {
+  stop(instance);
+
+  instance.m_engine = this;
+  instance.m_program = &program;
+  instance.m_uinput = &uinput;
+  instance.m_pc = 0;
+  instance.m_held = true;
+  instance.m_running = true;
+
+  // bring the wheel up to date, so that the first wait is measured
+  // from now
+  uint64_t now = get_ticks();
+  m_wheel.advance(now);
+  run(instance, now);
+  schedule();
+}
+
+void MacroEngine::stop(Instance& instance) {
+  m_wheel.remove(&instance);
+  instance.m_running = false;
+}
+
+void MacroEngine::run(Instance& instance, uint64_t time) {
+  const std::vector<MacroProgram::Op>& code = instance.m_program->get_code();
+
+  while (instance.m_pc < code.size()) {
+    const MacroProgram::Op& op = code[instance.m_pc];
+    instance.m_pc += 1;
+
+    switch (op.opcode) {
+      case MacroProgram::kSend: {
+        const UIEvent& event = instance.m_program->get_event(op.event);
+        instance.m_uinput->send(event.get_device_id(), event.type, event.code,
+                                op.arg);
+      } break;
+
+      case MacroProgram::kWait:
+        if (op.arg > 0) {
+          instance.m_uinput->sync();
+          m_wheel.add(&instance, time + op.arg);
+          return;
+        }
+        break;
+
+      case MacroProgram::kRepeat:
+        instance.m_counters[op.depth] = op.arg;
+        break;
+
+      case MacroProgram::kEnd:
+        if (instance.m_counters[op.depth] == 0) {
+          if (instance.m_held) {
+            instance.m_pc = op.arg;
+          }
+        } else {
+          instance.m_counters[op.depth] -= 1;
+          if (instance.m_counters[op.depth] > 0) {
+            instance.m_pc = op.arg;
+          }
+        }
+        break;
+
+      default:
+        assert(!"never reached");
+        break;
+    }
+  }
+
+  instance.m_uinput->sync();
+  instance.m_running = false;
+}
+
+void MacroEngine::schedule() {
+  if (m_wheel.empty()) {
+    g_source_set_ready_time(m_source, -1);
+  } else {
+    g_source_set_ready_time(
+        m_source, static_cast<gint64>(m_wheel.next_deadline() *
+                                      MacroProgram::kTickUsec));
+  }
+}
+
+gboolean MacroEngine::on_source() {
+  m_wheel.advance(get_ticks());
+  schedule();
+  return TRUE;
+}
+
+gboolean MacroEngine::on_source_dispatch(GSource* source, GSourceFunc callback,
+                                         gpointer userdata) {
+  return callback(userdata);
+}
+
+/* EOF */
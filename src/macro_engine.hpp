@@ -0,0 +1,100 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_MACRO_ENGINE_HPP
+#define HEADER_XBOXDRV_MACRO_ENGINE_HPP
+
+#include <glib.h>
+
+#include <cstdint>
+
+#include "macro_program.hpp"
+#include "timer_wheel.hpp"
+
+class UInput;
+
+/** Runs MacroPrograms. All running macros of all slots share one
+    TimerWheel that is driven by a single GSource armed for the next
+    deadline, so only macros that are due get touched. Wait times are
+    added to the previous deadline instead of the wakeup time, so a
+    late wakeup doesn't accumulate into drift. */
+class MacroEngine {
+ public:
+  /** The state of one running macro, owned by the caller so that
+      running a macro doesn't allocate */
+  class Instance : public TimerWheel::Timer {
+    friend class MacroEngine;
+
+   private:
+    MacroEngine* m_engine;
+    const MacroProgram* m_program;
+    UInput* m_uinput;
+    size_t m_pc;
+    int32_t m_counters[MacroProgram::kMaxDepth];
+    bool m_held;
+    bool m_running;
+
+   public:
+    Instance();
+    ~Instance();
+
+    bool is_running() const { return m_running; }
+
+    /** Signals that the button that started the macro was released,
+        which ends loops that repeat while held */
+    void release() { m_held = false; }
+
+    void expire(uint64_t now);
+  };
+
+ public:
+  static MacroEngine& current();
+
+ private:
+  TimerWheel m_wheel;
+  GSourceFuncs m_source_funcs;
+  GSource* m_source;
+
+ public:
+  MacroEngine();
+  ~MacroEngine();
+
+  void start(Instance& instance, const MacroProgram& program, UInput& uinput);
+  void stop(Instance& instance);
+
+ private:
+  static uint64_t get_ticks();
+
+  void run(Instance& instance, uint64_t time);
+  void schedule();
+
+  gboolean on_source();
+  static gboolean on_source_wrap(gpointer userdata) {
+    return static_cast<MacroEngine*>(userdata)->on_source();
+  }
+  static gboolean on_source_dispatch(GSource* source, GSourceFunc callback,
+                                     gpointer userdata);
+
+ private:
+  MacroEngine(const MacroEngine&);
+  MacroEngine& operator=(const MacroEngine&);
+};
+
+#endif
+
+/* EOF */
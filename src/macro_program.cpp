@@ -0,0 +1,214 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "macro_program.hpp"
+
+#include <linux/input.h>
+
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "raise_exception.hpp"
+#include "uinput.hpp"
+
+std::unique_ptr<MacroProgram> MacroProgram::from_string(
+    const std::string& source) {
+  std::unique_ptr<MacroProgram> program(new MacroProgram);
+
+  // start of the body and whether it waits, for each open repeat
+  std::vector<size_t> loops;
+  std::vector<bool> loop_waits;
+
+  std::istringstream in(source);
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    line_number += 1;
+    try {
+      program->compile_line(line, loops, loop_waits);
+    } catch (const std::exception& err) {
+      std::ostringstream out;
+      out << "line " << line_number << ": " << err.what();
+      throw std::runtime_error(out.str());
+    }
+  }
+
+  if (!loops.empty()) {
+    throw std::runtime_error("'repeat' without 'end'");
+  }
+
+  return program;
+}
+
+MacroProgram::MacroProgram() : m_code(), m_events(), m_absinfos() {}
+
+void MacroProgram::compile_line(const std::string& line,
+                                std::vector<size_t>& loops,
+                                std::vector<bool>& loop_waits) {
+  // split on whitespace, so that repeat blocks can be indented
+  std::vector<std::string> args;
+  std::istringstream tokens(line);
+  std::string token;
+  while (tokens >> token) {
+    args.push_back(token);
+  }
+
+  if (args.empty() || (!args[0].empty() && args[0][0] == '#')) {
+    // ignore empty lines and '#' comments
+  } else if (args[0] == "init") {
+    // FIXME: generalize this for EV_KEY and EV_REL
+    if (args.size() < 4) {
+      raise_exception(std::runtime_error,
+                      "'init' requires at least three arguments: " << line);
+    } else {
+      AbsInfo absinfo;
+      absinfo.event = UIEvent::from_string(args[1]);
+      absinfo.minimum = std::stoi(args[2]);
+      absinfo.maximum = std::stoi(args[3]);
+      absinfo.fuzz = 0;
+      absinfo.flat = 0;
+      if (args.size() > 4) absinfo.fuzz = std::stoi(args[4]);
+      if (args.size() > 5) absinfo.flat = std::stoi(args[5]);
+      m_absinfos.push_back(absinfo);
+    }
+  } else if (args[0] == "send") {
+    if (args.size() != 3) {
+      raise_exception(std::runtime_error,
+                      "'send' requires two arguments: " << line);
+    } else if (m_events.size() > 0xffff) {
+      throw std::runtime_error("too many events");
+    } else {
+      m_events.push_back(UIEvent::from_string(args[1]));
+      emit(kSend, 0, static_cast<int>(m_events.size() - 1),
+           std::stoi(args[2]));
+    }
+  } else if (args[0] == "wait") {
+    if (args.size() != 2) {
+      raise_exception(std::runtime_error,
+                      "'wait' requires one arguments: " << line);
+    } else {
+      float msec = std::stof(args[1]);
+      if (msec < 0) {
+        raise_exception(std::runtime_error, "negative 'wait': " << line);
+      } else {
+        int32_t ticks = static_cast<int32_t>(lroundf(msec * 1000 / kTickUsec));
+        if (ticks > 0 && !loop_waits.empty()) {
+          loop_waits.back() = true;
+        }
+        emit(kWait, 0, 0, ticks);
+      }
+    }
+  } else if (args[0] == "repeat") {
+    if (args.size() > 2) {
+      raise_exception(std::runtime_error,
+                      "'repeat' takes at most one argument: " << line);
+    } else if (loops.size() >= static_cast<size_t>(kMaxDepth)) {
+      throw std::runtime_error("'repeat' nested too deeply");
+    } else {
+      int count = 0;
+      if (args.size() == 2) {
+        count = std::stoi(args[1]);
+        if (count < 1) {
+          raise_exception(std::runtime_error,
+                          "'repeat' count must be positive: " << line);
+        }
+      }
+
+      emit(kRepeat, static_cast<int>(loops.size()), 0, count);
+      loops.push_back(m_code.size());
+      loop_waits.push_back(false);
+    }
+  } else if (args[0] == "end") {
+    if (loops.empty()) {
+      throw std::runtime_error("'end' without 'repeat'");
+    } else {
+      size_t body = loops.back();
+      bool waits = loop_waits.back();
+      loops.pop_back();
+      loop_waits.pop_back();
+
+      // a loop that runs while the button is held must give the main
+      // loop a chance to see the release
+      if (m_code[body - 1].arg == 0 && !waits) {
+        throw std::runtime_error(
+            "'repeat' without count needs a 'wait' in its body");
+      }
+
+      if (waits && !loop_waits.empty()) {
+        loop_waits.back() = true;
+      }
+
+      emit(kEnd, static_cast<int>(loops.size()), 0,
+           static_cast<int32_t>(body));
+    }
+  } else {
+    raise_exception(std::runtime_error, "unknown macro command: " << line);
+  }
+}
+
+void MacroProgram::emit(Opcode opcode, int depth, int event, int32_t arg) {
+  Op op;
+  op.opcode = static_cast<uint8_t>(opcode);
+  op.depth = static_cast<uint8_t>(depth);
+  op.event = static_cast<uint16_t>(event);
+  op.arg = arg;
+  m_code.push_back(op);
+}
+
+void MacroProgram::init(UInput& uinput, int slot, bool extra_devices) {
+  for (std::vector<AbsInfo>::iterator i = m_absinfos.begin();
+       i != m_absinfos.end(); ++i) {
+    switch (i->event.type) {
+      case EV_ABS:
+        i->event.resolve_device_id(slot, extra_devices);
+        uinput.add_abs(i->event.get_device_id(), i->event.code, i->minimum,
+                       i->maximum, i->fuzz, i->flat);
+        break;
+
+      default:
+        assert(!"not implemented");
+    }
+  }
+
+  for (std::vector<UIEvent>::iterator i = m_events.begin();
+       i != m_events.end(); ++i) {
+    i->resolve_device_id(slot, extra_devices);
+    switch (i->type) {
+      case EV_REL:
+        uinput.add_rel(i->get_device_id(), i->code);
+        break;
+
+      case EV_KEY:
+        uinput.add_key(i->get_device_id(), i->code);
+        break;
+
+      case EV_ABS:
+        // not doing a add_abs() here, its the users job to use a
+        // init command for that
+        break;
+
+      default:
+        assert(!"not implemented");
+        break;
+    }
+  }
+}
+
+/* EOF */
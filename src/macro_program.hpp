@@ -0,0 +1,92 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_MACRO_PROGRAM_HPP
+#define HEADER_XBOXDRV_MACRO_PROGRAM_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ui_event.hpp"
+
+class UInput;
+
+/** A .macro file compiled into a flat list of fixed size
+    instructions, executed by the MacroEngine */
+class MacroProgram {
+ public:
+  enum Opcode {
+    kSend,    // send m_events[event] with value arg
+    kWait,    // wait arg ticks
+    kRepeat,  // set the counter at depth to arg, 0 repeats while held
+    kEnd      // loop back to instruction arg while the counter allows
+  };
+
+  struct Op {
+    uint8_t opcode;
+    uint8_t depth;
+    uint16_t event;
+    int32_t arg;
+  };
+
+  /** length of a wait tick in microseconds */
+  static const int kTickUsec = 100;
+
+  /** maximum nesting of repeat blocks */
+  static const int kMaxDepth = 8;
+
+ private:
+  struct AbsInfo {
+    UIEvent event;
+    int minimum;
+    int maximum;
+    int fuzz;
+    int flat;
+  };
+
+  std::vector<Op> m_code;
+  std::vector<UIEvent> m_events;
+  std::vector<AbsInfo> m_absinfos;
+
+ public:
+  static std::unique_ptr<MacroProgram> from_string(const std::string& source);
+
+  MacroProgram();
+
+  /** Resolves the device ids of all events and registers them with
+      \a uinput */
+  void init(UInput& uinput, int slot, bool extra_devices);
+
+  const std::vector<Op>& get_code() const { return m_code; }
+  const UIEvent& get_event(int idx) const { return m_events[idx]; }
+
+ private:
+  void compile_line(const std::string& line, std::vector<size_t>& loops,
+                    std::vector<bool>& loop_waits);
+  void emit(Opcode opcode, int depth, int event, int32_t arg);
+
+ private:
+  MacroProgram(const MacroProgram&);
+  MacroProgram& operator=(const MacroProgram&);
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,82 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "message_monitor.hpp"
+
+#include <cstring>
+#include <map>
+#include <new>
+
+std::shared_ptr<MessageMonitor> MessageMonitor::get(
+    const std::string& filename) {
+  static std::map<std::string, std::weak_ptr<MessageMonitor> > monitors;
+
+  std::shared_ptr<MessageMonitor> monitor = monitors[filename].lock();
+  if (!monitor) {
+    monitor.reset(new MessageMonitor(filename));
+    monitors[filename] = monitor;
+  }
+  return monitor;
+}
+
+MessageMonitor::MessageMonitor(const std::string& filename)
+    : m_file(filename,
+             sizeof(MonitorHeader) + sizeof(MonitorRecord) * kMonitorRecords,
+             std::string(kMonitorMagic, sizeof(kMonitorMagic))),
+      m_header(),
+      m_records(),
+      m_next_source(0) {
+  // the file is zero filled, which is a valid state for the atomics
+  m_header = new (m_file.get_data()) MonitorHeader;
+  m_header->record_size = sizeof(MonitorRecord);
+  m_header->num_records = kMonitorRecords;
+  m_header->write_seq.store(0, std::memory_order_relaxed);
+
+  m_records = reinterpret_cast<MonitorRecord*>(
+      static_cast<char*>(m_file.get_data()) + sizeof(MonitorHeader));
+  for (uint32_t i = 0; i < kMonitorRecords; ++i) {
+    new (&m_records[i]) MonitorRecord;
+    m_records[i].seq.store(0, std::memory_order_relaxed);
+  }
+
+  // the magic goes in last, so a viewer never sees a half set up file
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(m_header->magic, kMonitorMagic, sizeof(kMonitorMagic));
+}
+
+MessageMonitor::~MessageMonitor() {}
+
+void MessageMonitor::write(uint32_t source, const XboxGenericMsg& msg,
+                           int64_t time) {
+  uint64_t seq = m_header->write_seq.load(std::memory_order_relaxed);
+  MonitorRecord& record = m_records[seq % kMonitorRecords];
+
+  // readers check seq before and after copying a record, so they
+  // notice when it was overwritten in between
+  record.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  record.time_usec = static_cast<uint64_t>(time / 1000);
+  record.source = source;
+  record.msg = msg;
+
+  record.seq.store(seq + 1, std::memory_order_release);
+  m_header->write_seq.store(seq + 1, std::memory_order_release);
+}
+
+/* EOF */
@@ -0,0 +1,89 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_MESSAGE_MONITOR_HPP
+#define HEADER_XBOXDRV_MESSAGE_MONITOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "shared_memory_file.hpp"
+#include "xboxmsg.hpp"
+
+/** The layout of the file written by MessageMonitor, shared with
+    tools/xboxdrv-monitor.cpp. A header is followed by a fixed number
+    of records used as a ring, the writer never waits for readers, a
+    reader that falls more than kMonitorRecords behind loses records. */
+const char kMonitorMagic[8] = {'X', 'B', 'D', 'M', 'O', 'N', '0', '1'};
+const uint32_t kMonitorRecords = 4096;
+
+struct MonitorHeader {
+  char magic[8];
+  uint32_t record_size;
+  uint32_t num_records;
+
+  /** sequence number the next record will get */
+  std::atomic<uint64_t> write_seq;
+};
+
+struct MonitorRecord {
+  /** sequence number plus one once the record is complete, zero
+      while it is written */
+  std::atomic<uint64_t> seq;
+  uint64_t time_usec;
+  uint32_t source;
+  uint32_t padding;
+  XboxGenericMsg msg;
+};
+
+/** Publishes every controller report as a fixed size binary record in
+    a memory mapped file, usually in /dev/shm. This replaces printing
+    the report to stdout, which formats and flushes for every report,
+    the formatting is left to a viewer reading the file. */
+class MessageMonitor {
+ public:
+  /** Returns the monitor writing to \a filename, all users of the same
+      file share one monitor */
+  static std::shared_ptr<MessageMonitor> get(const std::string& filename);
+
+ private:
+  SharedMemoryFile m_file;
+  MonitorHeader* m_header;
+  MonitorRecord* m_records;
+  uint32_t m_next_source;
+
+ public:
+  MessageMonitor(const std::string& filename);
+  ~MessageMonitor();
+
+  /** Returns a new id to tag the records of one controller with */
+  uint32_t add_source() { return m_next_source++; }
+
+  /** \a time is the CLOCK_MONOTONIC nsec at which \a msg arrived */
+  void write(uint32_t source, const XboxGenericMsg& msg, int64_t time);
+
+ private:
+  MessageMonitor(const MessageMonitor&);
+  MessageMonitor& operator=(const MessageMonitor&);
+};
+
+#endif
+
+/* EOF */
@@ -21,7 +21,9 @@
 
 #include <cstdint>
 #include <functional>
+#include <vector>
 
+struct ControllerKey;
 struct XboxGenericMsg;
 class Controller;
 
@@ -30,7 +32,21 @@ class MessageProcessor {
   MessageProcessor() {}
   virtual ~MessageProcessor() {}
 
-  virtual void send(const XboxGenericMsg& msg, int msec_delta) = 0;
+  /** \a time is the CLOCK_MONOTONIC nsec at which \a msg arrived,
+      or the current time when it is sent again, \a nsec_delta is the
+      time that passed since the previous call */
+  virtual void send(const XboxGenericMsg& msg, int64_t time,
+                    int64_t nsec_delta) = 0;
+
+  /** \a keys are the keys of an attached keyboard that changed in
+      one report, \a time is when the report arrived */
+  virtual void send_keys(const std::vector<ControllerKey>& keys,
+                         int64_t time) {}
+
+  /** Returns true if the last message has to be sent again
+      periodically, as some part of the mapping changes over time,
+      such as autofire or relative axis */
+  virtual bool needs_update() const { return false; }
   virtual void set_controller(Controller* controller) = 0;
 
  private:
@@ -19,6 +19,7 @@
 #ifndef HEADER_MODIFIER_HPP
 #define HEADER_MODIFIER_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -36,7 +37,11 @@ class Modifier {
 
  public:
   virtual ~Modifier() {}
-  virtual void update(int msec_delta, XboxGenericMsg& msg) = 0;
+  virtual void update(int64_t nsec_delta, XboxGenericMsg& msg) = 0;
+
+  /** Returns true while the modifier changes its output over time,
+      without new messages coming in */
+  virtual bool needs_update() const { return false; }
 
   virtual std::string str() const = 0;
 };
@@ -69,7 +69,7 @@ AxisMapping AxisMapping::from_string(const std::string& lhs_,
 
 AxismapModifier::AxismapModifier() : m_axismap() {}
 
-void AxismapModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void AxismapModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   XboxGenericMsg newmsg = msg;
 
   // update all filters in all mappings
@@ -77,7 +77,7 @@ void AxismapModifier::update(int msec_delta, XboxGenericMsg& msg) {
        i != m_axismap.end(); ++i) {
     for (std::vector<AxisFilterPtr>::iterator j = i->filters.begin();
          j != i->filters.end(); ++j) {
-      (*j)->update(msec_delta);
+      (*j)->update(nsec_delta);
     }
   }
 
@@ -118,6 +118,19 @@ void AxismapModifier::update(int msec_delta, XboxGenericMsg& msg) {
   msg = newmsg;
 }
 
+bool AxismapModifier::needs_update() const {
+  for (std::vector<AxisMapping>::const_iterator i = m_axismap.begin();
+       i != m_axismap.end(); ++i) {
+    for (std::vector<AxisFilterPtr>::const_iterator j = i->filters.begin();
+         j != i->filters.end(); ++j) {
+      if ((*j)->needs_update()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void AxismapModifier::add(const AxisMapping& mapping) {
   m_axismap.push_back(mapping);
 }
@@ -44,7 +44,8 @@ class AxismapModifier : public Modifier {
  public:
   AxismapModifier();
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
+  bool needs_update() const;
 
   void add(const AxisMapping& mapping);
   void add_filter(XboxAxis axis, AxisFilterPtr filter);
@@ -55,7 +55,7 @@ ButtonMapping ButtonMapping::from_string(const std::string& lhs,
 
 ButtonmapModifier::ButtonmapModifier() : m_buttonmap() {}
 
-void ButtonmapModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void ButtonmapModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   XboxGenericMsg newmsg = msg;
 
   // update all filters in all mappings
@@ -63,7 +63,7 @@ void ButtonmapModifier::update(int msec_delta, XboxGenericMsg& msg) {
        i != m_buttonmap.end(); ++i) {
     for (std::vector<ButtonFilterPtr>::iterator j = i->filters.begin();
          j != i->filters.end(); ++j) {
-      (*j)->update(msec_delta);
+      (*j)->update(nsec_delta);
     }
   }
 
@@ -91,6 +91,19 @@ void ButtonmapModifier::update(int msec_delta, XboxGenericMsg& msg) {
   msg = newmsg;
 }
 
+bool ButtonmapModifier::needs_update() const {
+  for (std::vector<ButtonMapping>::const_iterator i = m_buttonmap.begin();
+       i != m_buttonmap.end(); ++i) {
+    for (std::vector<ButtonFilterPtr>::const_iterator j = i->filters.begin();
+         j != i->filters.end(); ++j) {
+      if ((*j)->needs_update()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void ButtonmapModifier::add(const ButtonMapping& mapping) {
   m_buttonmap.push_back(mapping);
 }
@@ -40,7 +40,8 @@ class ButtonmapModifier : public Modifier {
  public:
   ButtonmapModifier();
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
+  bool needs_update() const;
 
   void add(const ButtonMapping& mapping);
   void add_filter(XboxButton btn, ButtonFilterPtr filter);
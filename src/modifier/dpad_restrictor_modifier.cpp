@@ -47,7 +47,7 @@ DpadRestrictorModifier* DpadRestrictorModifier::from_string(
 DpadRestrictorModifier::DpadRestrictorModifier(Mode mode)
     : m_mode(mode), m_last_unpressed_axis(XBOX_AXIS_DPAD_X) {}
 
-void DpadRestrictorModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void DpadRestrictorModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   switch (m_mode) {
     case kRestrictFourWay:
       if (get_axis(msg, XBOX_AXIS_DPAD_X) && get_axis(msg, XBOX_AXIS_DPAD_Y)) {
@@ -35,7 +35,7 @@ class DpadRestrictorModifier : public Modifier {
  public:
   DpadRestrictorModifier(Mode mode);
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
   std::string str() const;
 
  private:
@@ -47,7 +47,7 @@ DpadRotationModifier* DpadRotationModifier::from_string(
 DpadRotationModifier::DpadRotationModifier(int dpad_rotation)
     : m_dpad_rotation(dpad_rotation) {}
 
-void DpadRotationModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void DpadRotationModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   int up = get_button(msg, XBOX_DPAD_UP);
   int down = get_button(msg, XBOX_DPAD_DOWN);
   int left = get_button(msg, XBOX_DPAD_LEFT);
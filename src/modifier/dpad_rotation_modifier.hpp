@@ -38,7 +38,7 @@ class DpadRotationModifier : public Modifier {
  public:
   DpadRotationModifier(int dpad_rotation);
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
 
   std::string str() const;
 
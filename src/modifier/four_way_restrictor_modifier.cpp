@@ -37,7 +37,8 @@ FourWayRestrictorModifier::FourWayRestrictorModifier(XboxAxis xaxis,
                                                      XboxAxis yaxis)
     : m_xaxis(xaxis), m_yaxis(yaxis) {}
 
-void FourWayRestrictorModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void FourWayRestrictorModifier::update(int64_t nsec_delta,
+                                       XboxGenericMsg& msg) {
   if (abs(get_axis(msg, m_xaxis)) > abs(get_axis(msg, m_yaxis))) {
     set_axis(msg, m_yaxis, 0);
   } else if (abs(get_axis(msg, m_yaxis)) > abs(get_axis(msg, m_xaxis))) {
@@ -32,7 +32,7 @@ class FourWayRestrictorModifier : public Modifier {
  public:
   FourWayRestrictorModifier(XboxAxis xaxis, XboxAxis yaxis);
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
 
   std::string str() const;
 
@@ -41,7 +41,7 @@ RotateAxisModifier::RotateAxisModifier(XboxAxis xaxis, XboxAxis yaxis,
                                        float angle, bool mirror)
     : m_xaxis(xaxis), m_yaxis(yaxis), m_angle(angle), m_mirror(mirror) {}
 
-void RotateAxisModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void RotateAxisModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   float x = get_axis_float(msg, m_xaxis);
   float y = get_axis_float(msg, m_yaxis);
 
@@ -31,7 +31,7 @@ class RotateAxisModifier : public Modifier {
  public:
   RotateAxisModifier(XboxAxis xaxis, XboxAxis yaxis, float angle, bool mirror);
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
   std::string str() const;
 
  private:
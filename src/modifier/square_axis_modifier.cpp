@@ -64,7 +64,7 @@ SquareAxisModifier* SquareAxisModifier::from_string(
 SquareAxisModifier::SquareAxisModifier(XboxAxis xaxis, XboxAxis yaxis)
     : m_xaxis(xaxis), m_yaxis(yaxis) {}
 
-void SquareAxisModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void SquareAxisModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   int x = get_axis(msg, m_xaxis);
   int y = get_axis(msg, m_yaxis);
 
@@ -31,7 +31,7 @@ class SquareAxisModifier : public Modifier {
  public:
   SquareAxisModifier(XboxAxis x_axis, XboxAxis y_axis);
 
-  void update(int msec_delta, XboxGenericMsg& msg);
+  void update(int64_t nsec_delta, XboxGenericMsg& msg);
 
   std::string str() const;
 
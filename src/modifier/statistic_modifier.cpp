@@ -48,7 +48,7 @@ void StatisticModifier::print_stats() {
   }
 }
 
-void StatisticModifier::update(int msec_delta, XboxGenericMsg& msg) {
+void StatisticModifier::update(int64_t nsec_delta, XboxGenericMsg& msg) {
   for (int btn = 1; btn < static_cast<int>(XBOX_BTN_MAX); ++btn) {
     bool state = get_button(msg, static_cast<XboxButton>(btn));
 
@@ -18,6 +18,8 @@
 
 #include "options.hpp"
 
+#include <sched.h>
+
 #include <cassert>
 #include <format>
 #include <functional>
@@ -71,9 +73,17 @@ Options::Options()
       wireless_id(0),
       instant_exit(false),
       no_uinput(false),
+      uinput_socket(),
       detach_kernel_driver(),
       timeout(10),
+      decimation(0),
+      monitor(),
+      export_state(),
       priority(kPriorityNormal),
+      sched_policy(kSchedRR),
+      sched_priority(0),
+      mlock(false),
+      cpu_affinity(),
       gamepad_type(GAMEPAD_UNKNOWN),
       busid(),
       devid(),
@@ -97,6 +107,8 @@ Options::Options()
       pid_file(),
       on_connect(),
       on_disconnect(),
+      args(),
+      working_directory(),
       exec(),
       list_enums(0),
       config_toggle_button(XBOX_BTN_UNKNOWN),
@@ -105,6 +117,8 @@ Options::Options()
       config_slot(0),
       extra_devices(true),
       extra_events(true),
+      rel_rate(100),
+      wheel_hi_res(false),
       uinput_device_names(),
       uinput_device_usbids(),
       usb_debug(false),
@@ -146,8 +160,26 @@ const ControllerOptions& Options::get_controller_options() const {
 }
 
 void Options::set_priority(const std::string& value) {
-  if (value == "realtime") {
+  std::string::size_type colon = value.find(':');
+  std::string policy = value.substr(0, colon);
+  int prio = 0;
+  if (colon != std::string::npos) {
+    prio = std::stoi(value.substr(colon + 1));
+    if (prio < 1 || prio > 99) {
+      raise_exception(std::runtime_error,
+                      "realtime priority must be between 1 and 99: '"
+                          << value << "'");
+    }
+  }
+
+  if (policy == "realtime" || policy == "rr") {
+    priority = kPriorityRealtime;
+    sched_policy = kSchedRR;
+    sched_priority = prio;
+  } else if (policy == "fifo") {
     priority = kPriorityRealtime;
+    sched_policy = kSchedFifo;
+    sched_priority = prio;
   } else if (value == "normal") {
     priority = kPriorityNormal;
   } else {
@@ -156,6 +188,39 @@ void Options::set_priority(const std::string& value) {
   }
 }
 
+void Options::set_cpu_affinity(const std::string& value) {
+  cpu_affinity.clear();
+  for (const std::string& token : string_split(value, ",")) {
+    std::string lhs, rhs;
+    split_string_at(token, '-', &lhs, &rhs);
+    int first = std::stoi(lhs);
+    int last = rhs.empty() ? first : std::stoi(rhs);
+    if (first < 0 || last < first || last >= CPU_SETSIZE) {
+      raise_exception(std::runtime_error,
+                      "invalid CPU range: '" << token << "'");
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpu_affinity.push_back(cpu);
+    }
+  }
+}
+
+void Options::set_rel_rate(const std::string& value) {
+  rel_rate = std::stoi(value);
+  if (rel_rate < 1 || rel_rate > 1000) {
+    raise_exception(std::runtime_error,
+                    "rel rate must be between 1 and 1000: '" << value << "'");
+  }
+}
+
+void Options::set_decimation(const std::string& value) {
+  decimation = std::stoi(value);
+  if (decimation < 0) {
+    raise_exception(std::runtime_error,
+                    "decimation must not be negative: '" << value << "'");
+  }
+}
+
 void Options::set_ui_clear() {
   get_controller_options().uinput.get_axis_map().clear();
   get_controller_options().uinput.get_btn_map().clear();
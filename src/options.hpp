@@ -57,6 +57,7 @@ class Options {
   };
 
   enum Priority { kPriorityNormal, kPriorityRealtime };
+  enum SchedPolicy { kSchedRR, kSchedFifo };
 
   // General program options
   bool silent;
@@ -69,9 +70,17 @@ class Options {
   int wireless_id;
   bool instant_exit;
   bool no_uinput;
+  std::string uinput_socket;
   bool detach_kernel_driver;
   int timeout;
+  int decimation;
+  std::string monitor;
+  std::string export_state;
   Priority priority;
+  SchedPolicy sched_policy;
+  int sched_priority;  /// 0 for the highest available
+  bool mlock;
+  std::vector<int> cpu_affinity;
 
   GamepadType gamepad_type;
 
@@ -116,6 +125,11 @@ class Options {
   std::string on_connect;
   std::string on_disconnect;
 
+  /** the command line and the directory it was given in, used to
+      parse the config again when the daemon is told to reload */
+  std::vector<std::string> args;
+  std::string working_directory;
+
   std::vector<std::string> exec;
 
   uint32_t list_enums;
@@ -128,6 +142,8 @@ class Options {
 
   bool extra_devices;
   bool extra_events;
+  int rel_rate;
+  bool wheel_hi_res;
 
   std::map<uint32_t, std::string> uinput_device_names;
   std::map<uint32_t, struct input_id> uinput_device_usbids;
@@ -176,6 +192,9 @@ class Options {
   const ControllerOptions& get_controller_options() const;
 
   void set_priority(const std::string& value);
+  void set_cpu_affinity(const std::string& value);
+  void set_rel_rate(const std::string& value);
+  void set_decimation(const std::string& value);
 
   void set_ui_clear();
 
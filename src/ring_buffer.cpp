@@ -0,0 +1,84 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+  size_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+RingBuffer::RingBuffer(size_t capacity)
+    : m_data(round_up_pow2(capacity)),
+      m_mask(m_data.size() - 1),
+      m_read_pos(0),
+      m_write_pos(0) {}
+
+size_t RingBuffer::read_available() const {
+  return m_write_pos.load(std::memory_order_acquire) -
+         m_read_pos.load(std::memory_order_relaxed);
+}
+
+size_t RingBuffer::write_available() const {
+  return m_data.size() - (m_write_pos.load(std::memory_order_relaxed) -
+                          m_read_pos.load(std::memory_order_acquire));
+}
+
+size_t RingBuffer::write(const uint8_t* data, size_t len) {
+  size_t pos = m_write_pos.load(std::memory_order_relaxed);
+  len = std::min(len, write_available());
+
+  // copy in at most two pieces, the second one after wrapping around
+  size_t offset = pos & m_mask;
+  size_t first = std::min(len, m_data.size() - offset);
+  memcpy(&m_data[offset], data, first);
+  memcpy(&m_data[0], data + first, len - first);
+
+  m_write_pos.store(pos + len, std::memory_order_release);
+  return len;
+}
+
+size_t RingBuffer::read(uint8_t* data, size_t len) {
+  size_t pos = m_read_pos.load(std::memory_order_relaxed);
+  len = std::min(len, read_available());
+
+  size_t offset = pos & m_mask;
+  size_t first = std::min(len, m_data.size() - offset);
+  memcpy(data, &m_data[offset], first);
+  memcpy(data + first, &m_data[0], len - first);
+
+  m_read_pos.store(pos + len, std::memory_order_release);
+  return len;
+}
+
+void RingBuffer::clear() {
+  m_read_pos.store(0, std::memory_order_relaxed);
+  m_write_pos.store(0, std::memory_order_relaxed);
+}
+
+/* EOF */
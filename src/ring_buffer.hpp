@@ -0,0 +1,68 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_RING_BUFFER_HPP
+#define HEADER_XBOXDRV_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** A lock-free byte ring buffer for exactly one writer thread and one
+    reader thread. The capacity is rounded up to a power of two. */
+class RingBuffer {
+ private:
+  std::vector<uint8_t> m_data;
+  size_t m_mask;
+
+  // total bytes ever read and written, the difference is the fill level
+  std::atomic<size_t> m_read_pos;
+  std::atomic<size_t> m_write_pos;
+
+ public:
+  RingBuffer(size_t capacity);
+
+  size_t capacity() const { return m_data.size(); }
+
+  /** Number of bytes that can be read, only exact for the reader */
+  size_t read_available() const;
+
+  /** Number of bytes that can be written, only exact for the writer */
+  size_t write_available() const;
+
+  /** Copies up to \a len bytes into the buffer, returns the number of
+      bytes copied */
+  size_t write(const uint8_t* data, size_t len);
+
+  /** Copies up to \a len bytes out of the buffer, returns the number
+      of bytes copied */
+  size_t read(uint8_t* data, size_t len);
+
+  /** Empties the buffer, neither the reader nor the writer may use it
+      at the same time */
+  void clear();
+
+ private:
+  RingBuffer(const RingBuffer&);
+  RingBuffer& operator=(const RingBuffer&);
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,305 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scheduling.hpp"
+
+#include <dbus/dbus.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "log.hpp"
+#include "options.hpp"
+
+namespace {
+
+// set when --cpu-affinity reserved CPUs for the input thread
+bool g_have_helper_cpus = false;
+cpu_set_t g_helper_cpus;
+
+// set when the input thread was pinned, the CPUs the process had
+// before, given back to spawned children
+bool g_have_process_cpus = false;
+cpu_set_t g_process_cpus;
+
+// rtkit refuses threads without RLIMIT_RTTIME, its default maximum is
+// 200 msec
+const rlim_t kRtkitRTTimeUsec = 200000;
+
+/** Returns rtkit's MaxRealtimePriority property or -1 */
+int rtkit_max_priority(DBusConnection* connection) {
+  DBusMessage* msg = dbus_message_new_method_call(
+      "org.freedesktop.RealtimeKit1", "/org/freedesktop/RealtimeKit1",
+      "org.freedesktop.DBus.Properties", "Get");
+  const char* interface = "org.freedesktop.RealtimeKit1";
+  const char* property = "MaxRealtimePriority";
+  dbus_message_append_args(msg, DBUS_TYPE_STRING, &interface,
+                           DBUS_TYPE_STRING, &property, DBUS_TYPE_INVALID);
+
+  DBusMessage* reply =
+      dbus_connection_send_with_reply_and_block(connection, msg, -1, NULL);
+  dbus_message_unref(msg);
+  if (!reply) {
+    return -1;
+  }
+
+  int result = -1;
+  DBusMessageIter iter;
+  DBusMessageIter variant;
+  if (dbus_message_iter_init(reply, &iter) &&
+      dbus_message_iter_get_arg_type(&iter) == DBUS_TYPE_VARIANT) {
+    dbus_message_iter_recurse(&iter, &variant);
+    if (dbus_message_iter_get_arg_type(&variant) == DBUS_TYPE_INT32) {
+      dbus_int32_t value;
+      dbus_message_iter_get_basic(&variant, &value);
+      result = value;
+    }
+  }
+  dbus_message_unref(reply);
+  return result;
+}
+
+/** Asks rtkit to make thread \a tid realtime, returns the priority
+    granted or 0 and sets \a error when it refuses */
+int rtkit_make_realtime(pid_t tid, int priority, std::string* error) {
+  DBusError err;
+  dbus_error_init(&err);
+
+  DBusConnection* connection = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
+  if (!connection) {
+    *error = err.message;
+    dbus_error_free(&err);
+    return 0;
+  }
+
+  // the connection is shared with the rest of the process, losing the
+  // system bus must not terminate it
+  dbus_connection_set_exit_on_disconnect(connection, FALSE);
+
+  // rtkit refuses anything above its limit instead of clamping
+  int max_priority = rtkit_max_priority(connection);
+  if (max_priority > 0) {
+    priority = std::min(priority, max_priority);
+  }
+
+  DBusMessage* msg = dbus_message_new_method_call(
+      "org.freedesktop.RealtimeKit1", "/org/freedesktop/RealtimeKit1",
+      "org.freedesktop.RealtimeKit1", "MakeThreadRealtime");
+  dbus_uint64_t thread = static_cast<dbus_uint64_t>(tid);
+  dbus_uint32_t prio = static_cast<dbus_uint32_t>(priority);
+  dbus_message_append_args(msg, DBUS_TYPE_UINT64, &thread, DBUS_TYPE_UINT32,
+                           &prio, DBUS_TYPE_INVALID);
+
+  DBusMessage* reply =
+      dbus_connection_send_with_reply_and_block(connection, msg, -1, &err);
+  dbus_message_unref(msg);
+  dbus_connection_unref(connection);
+
+  if (!reply) {
+    *error = err.message;
+    dbus_error_free(&err);
+    return 0;
+  } else {
+    dbus_message_unref(reply);
+    return priority;
+  }
+}
+
+/** Tries root, then RLIMIT_RTPRIO, then rtkit, returns the priority
+    that was set or 0 */
+int make_realtime(int policy, int priority, std::string* error) {
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = priority;
+
+  // threads and processes started from the input thread fall back to
+  // SCHED_OTHER, rtkit sets this flag on its own
+  policy |= SCHED_RESET_ON_FORK;
+
+  int ret = pthread_setschedparam(pthread_self(), policy, &param);
+  if (ret == 0) {
+    return priority;
+  } else if (ret != EPERM) {
+    *error = strerror(ret);
+    return 0;
+  }
+
+  // unprivileged users may go up to RLIMIT_RTPRIO
+  struct rlimit rtprio;
+  if (getrlimit(RLIMIT_RTPRIO, &rtprio) == 0 && rtprio.rlim_max > 0) {
+    int allowed = static_cast<int>(
+        std::min(rtprio.rlim_max, static_cast<rlim_t>(priority)));
+    if (rtprio.rlim_cur < static_cast<rlim_t>(allowed)) {
+      rtprio.rlim_cur = allowed;
+      setrlimit(RLIMIT_RTPRIO, &rtprio);
+    }
+
+    param.sched_priority = allowed;
+    if (pthread_setschedparam(pthread_self(), policy, &param) == 0) {
+      return allowed;
+    }
+  }
+
+  struct rlimit rttime;
+  if (getrlimit(RLIMIT_RTTIME, &rttime) == 0 &&
+      (rttime.rlim_max == RLIM_INFINITY ||
+       rttime.rlim_max > kRtkitRTTimeUsec)) {
+    rttime.rlim_cur = kRtkitRTTimeUsec;
+    rttime.rlim_max = kRtkitRTTimeUsec;
+    setrlimit(RLIMIT_RTTIME, &rttime);
+  }
+
+  // rtkit only hands out SCHED_RR
+  return rtkit_make_realtime(gettid(), priority, error);
+}
+
+/** Moves all other threads of the process to the helper CPUs */
+void move_other_threads() {
+  DIR* dir = opendir("/proc/self/task");
+  if (dir) {
+    pid_t self = gettid();
+    while (struct dirent* entry = readdir(dir)) {
+      pid_t tid = atoi(entry->d_name);
+      if (tid > 0 && tid != self) {
+        sched_setaffinity(tid, sizeof(g_helper_cpus), &g_helper_cpus);
+      }
+    }
+    closedir(dir);
+  }
+}
+
+}  // namespace
+
+void setup_input_thread_scheduling(const Options& opts) {
+  if (opts.mlock) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+      log_warn("mlockall() failed, memory stays swappable: "
+               << strerror(errno)
+               << " (check RLIMIT_MEMLOCK with 'ulimit -l')");
+    } else {
+      log_info("memory locked");
+    }
+  }
+
+  if (!opts.cpu_affinity.empty()) {
+    cpu_set_t all;
+    CPU_ZERO(&all);
+    sched_getaffinity(0, sizeof(all), &all);
+
+    cpu_set_t input;
+    CPU_ZERO(&input);
+    for (std::vector<int>::const_iterator i = opts.cpu_affinity.begin();
+         i != opts.cpu_affinity.end(); ++i) {
+      CPU_SET(*i, &input);
+    }
+
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(input), &input);
+    if (ret != 0) {
+      log_warn("couldn't set CPU affinity: " << strerror(ret));
+    } else {
+      g_process_cpus = all;
+      g_have_process_cpus = true;
+
+      // helpers get whatever is left, if anything is
+      CPU_XOR(&g_helper_cpus, &all, &input);
+      CPU_AND(&g_helper_cpus, &g_helper_cpus, &all);
+      g_have_helper_cpus = CPU_COUNT(&g_helper_cpus) > 0;
+      if (g_have_helper_cpus) {
+        move_other_threads();
+      }
+      log_info("input thread pinned to " << CPU_COUNT(&input) << " CPU(s), "
+                                         << CPU_COUNT(&g_helper_cpus)
+                                         << " left for helper threads");
+    }
+  }
+
+  if (opts.priority == Options::kPriorityRealtime) {
+    int policy =
+        (opts.sched_policy == Options::kSchedFifo) ? SCHED_FIFO : SCHED_RR;
+    int priority = opts.sched_priority;
+    if (priority <= 0) {
+      priority = sched_get_priority_max(policy);
+    }
+
+    std::string error;
+    int result = make_realtime(policy, priority, &error);
+    if (result == 0) {
+      log_warn("couldn't enable realtime scheduling, running at normal "
+               "priority: "
+               << error);
+    } else {
+      int actual_policy;
+      struct sched_param param;
+      pthread_getschedparam(pthread_self(), &actual_policy, &param);
+      actual_policy &= ~SCHED_RESET_ON_FORK;
+      log_info("input thread running with "
+               << (actual_policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR")
+               << " priority " << param.sched_priority);
+    }
+  }
+}
+
+void setup_helper_thread_scheduling() {
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+
+  if (g_have_helper_cpus) {
+    pthread_setaffinity_np(pthread_self(), sizeof(g_helper_cpus),
+                           &g_helper_cpus);
+  }
+}
+
+ChildScheduling::ChildScheduling(posix_spawnattr_t* attr)
+    : m_restore_affinity(false), m_affinity() {
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  posix_spawnattr_setschedpolicy(attr, SCHED_OTHER);
+  posix_spawnattr_setschedparam(attr, &param);
+
+  short flags = 0;
+  posix_spawnattr_getflags(attr, &flags);
+  posix_spawnattr_setflags(attr, flags | POSIX_SPAWN_SETSCHEDULER);
+
+  // the child inherits the affinity of the spawning thread and
+  // posix_spawn() has no attribute for it
+  if (g_have_process_cpus &&
+      pthread_getaffinity_np(pthread_self(), sizeof(m_affinity),
+                             &m_affinity) == 0) {
+    m_restore_affinity =
+        pthread_setaffinity_np(pthread_self(), sizeof(g_process_cpus),
+                               &g_process_cpus) == 0;
+  }
+}
+
+ChildScheduling::~ChildScheduling() {
+  if (m_restore_affinity) {
+    pthread_setaffinity_np(pthread_self(), sizeof(m_affinity), &m_affinity);
+  }
+}
+
+/* EOF */
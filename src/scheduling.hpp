@@ -0,0 +1,63 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_SCHEDULING_HPP
+#define HEADER_XBOXDRV_SCHEDULING_HPP
+
+#include <sched.h>
+#include <spawn.h>
+
+class Options;
+
+/** Applies --priority, --mlock and --cpu-affinity to the calling
+    thread, which is the one running the main loop and thus handles
+    USB transfers and all slots. Call it right before entering the
+    main loop, after libusb, glib and dbus have started their threads,
+    as those would inherit the realtime priority. Threads that already
+    exist are moved off the CPUs reserved for it. Realtime scheduling
+    falls back to RLIMIT_RTPRIO and then to rtkit when not running as
+    root, failures are logged and not fatal. */
+void setup_input_thread_scheduling(const Options& opts);
+
+/** Must be called at the start of helper threads (logging, audio
+    I/O), as they would otherwise inherit the realtime priority and
+    CPU affinity of the thread that created them */
+void setup_helper_thread_scheduling();
+
+/** Used around posix_spawn() to start a child at normal priority:
+    \a attr gets SCHED_OTHER and the calling thread gets back the CPU
+    affinity the process had before --cpu-affinity, until destroyed.
+    The RLIMIT_RTTIME lowered for rtkit stays, it is only enforced on
+    realtime tasks. */
+class ChildScheduling {
+ private:
+  bool m_restore_affinity;
+  cpu_set_t m_affinity;
+
+ public:
+  ChildScheduling(posix_spawnattr_t* attr);
+  ~ChildScheduling();
+
+ private:
+  ChildScheduling(const ChildScheduling&);
+  ChildScheduling& operator=(const ChildScheduling&);
+};
+
+#endif
+
+/* EOF */
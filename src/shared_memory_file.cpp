@@ -0,0 +1,103 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "shared_memory_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "raise_exception.hpp"
+
+namespace {
+
+/** Removes an old file at \a filename, but only when it starts with
+    \a magic, anything else is most likely a mistyped path */
+void remove_old_file(const std::string& filename, const std::string& magic) {
+  int fd = open(filename.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return;
+    } else {
+      raise_exception(std::runtime_error,
+                      "couldn't open " << filename << ": " << strerror(errno));
+    }
+  }
+
+  struct stat st;
+  std::string data(magic.size(), '\0');
+  bool ours = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+              read(fd, &data[0], data.size()) ==
+                  static_cast<ssize_t>(data.size()) &&
+              data == magic;
+  close(fd);
+
+  if (!ours) {
+    raise_exception(std::runtime_error,
+                    "refusing to replace " << filename
+                                           << ", it wasn't created by xboxdrv");
+  }
+
+  unlink(filename.c_str());
+}
+
+}  // namespace
+
+SharedMemoryFile::SharedMemoryFile(const std::string& filename, size_t size,
+                                   const std::string& magic)
+    : m_filename(filename), m_fd(-1), m_size(size), m_data(MAP_FAILED) {
+  // a reader still attached to an old file keeps its copy, it has to
+  // reopen to see the new one
+  remove_old_file(m_filename, magic);
+
+  m_fd = open(m_filename.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (m_fd < 0) {
+    raise_exception(std::runtime_error,
+                    "couldn't create " << m_filename << ": " << strerror(errno));
+  }
+
+  if (ftruncate(m_fd, static_cast<off_t>(m_size)) != 0) {
+    int err = errno;
+    close(m_fd);
+    unlink(m_filename.c_str());
+    raise_exception(std::runtime_error,
+                    "couldn't resize " << m_filename << ": " << strerror(err));
+  }
+
+  m_data = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (m_data == MAP_FAILED) {
+    int err = errno;
+    close(m_fd);
+    unlink(m_filename.c_str());
+    raise_exception(std::runtime_error,
+                    "couldn't map " << m_filename << ": " << strerror(err));
+  }
+}
+
+SharedMemoryFile::~SharedMemoryFile() {
+  munmap(m_data, m_size);
+  close(m_fd);
+  unlink(m_filename.c_str());
+}
+
+/* EOF */
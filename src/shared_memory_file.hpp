@@ -0,0 +1,52 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_SHARED_MEMORY_FILE_HPP
+#define HEADER_XBOXDRV_SHARED_MEMORY_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/** A zero filled file of a fixed size mapped into memory, for
+    publishing data to other processes, usually created in /dev/shm.
+    The data has to start with \a magic. An old file of the same name
+    is only replaced when it starts with it as well, anything else is
+    an error. The file is removed again on destruction. */
+class SharedMemoryFile {
+ private:
+  std::string m_filename;
+  int m_fd;
+  size_t m_size;
+  void* m_data;
+
+ public:
+  SharedMemoryFile(const std::string& filename, size_t size,
+                   const std::string& magic);
+  ~SharedMemoryFile();
+
+  void* get_data() const { return m_data; }
+  size_t get_size() const { return m_size; }
+
+ private:
+  SharedMemoryFile(const SharedMemoryFile&);
+  SharedMemoryFile& operator=(const SharedMemoryFile&);
+};
+
+#endif
+
+/* EOF */
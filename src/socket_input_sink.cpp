@@ -0,0 +1,301 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "socket_input_sink.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "log.hpp"
+#include "raise_exception.hpp"
+
+SocketInputSink::SocketInputSink(const std::string& path)
+    : m_path(path),
+      m_fd(-1),
+      m_next_device(0),
+      m_frames(),
+      m_pending(),
+      m_dropped(0),
+      m_flush_id(),
+      m_io_channel(),
+      m_writable_id() {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (m_path.size() >= sizeof(addr.sun_path)) {
+    raise_exception(std::runtime_error, "socket path too long: " << m_path);
+  }
+  strncpy(addr.sun_path, m_path.c_str(), sizeof(addr.sun_path) - 1);
+
+  m_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (m_fd < 0) {
+    raise_exception(std::runtime_error,
+                    "couldn't create socket: " << strerror(errno));
+  }
+
+  if (connect(m_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) !=
+      0) {
+    int err = errno;
+    close(m_fd);
+    raise_exception(std::runtime_error,
+                    "couldn't connect to " << m_path << ": " << strerror(err));
+  }
+
+  m_io_channel = g_io_channel_unix_new(m_fd);
+}
+
+SocketInputSink::~SocketInputSink() {
+  if (m_fd >= 0) {
+    // give the consumer what is left, but don't wait for it
+    flush();
+  }
+
+  if (m_flush_id) {
+    g_source_remove(m_flush_id);
+  }
+
+  if (m_writable_id) {
+    g_source_remove(m_writable_id);
+  }
+
+  g_io_channel_unref(m_io_channel);
+
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+uint32_t SocketInputSink::add_device(const std::string& name,
+                                     const struct input_id& id) {
+  Packet packet;
+  packet.header.type = SocketInputPacket::kAddDevice;
+  packet.header.device = m_next_device++;
+  packet.payload.assign(reinterpret_cast<const char*>(&id), sizeof(id));
+  packet.payload += name;
+  queue(packet);
+  return packet.header.device;
+}
+
+void SocketInputSink::remove_device(uint32_t device) {
+  m_frames.erase(device);
+
+  Packet packet;
+  packet.header.type = SocketInputPacket::kRemoveDevice;
+  packet.header.device = device;
+  queue(packet);
+}
+
+void SocketInputSink::send(uint32_t device, const struct input_event& ev) {
+  std::vector<struct input_event>& frame = m_frames[device];
+  frame.push_back(ev);
+
+  if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+    queue_frame(device, frame);
+    frame.clear();
+  }
+}
+
+void SocketInputSink::queue(const Packet& packet) {
+  if (m_fd < 0) {
+    // consumer is gone
+  } else if (m_pending.size() >= kMaxQueued) {
+    // even key events pile up, the consumer stopped reading
+    log_error("consumer at " << m_path << " stopped reading, disconnecting");
+    disconnect();
+  } else if (m_pending.size() >= kMaxPending &&
+             packet.header.type == SocketInputPacket::kFrame &&
+             !has_key_event(packet)) {
+    // a key press or release would stay lost, so only frames without
+    // one are dropped
+    m_dropped += 1;
+  } else {
+    m_pending.push_back(packet);
+    schedule_flush();
+  }
+}
+
+void SocketInputSink::queue_frame(uint32_t device,
+                                  std::vector<struct input_event>& frame) {
+  // only the newest queued packet of the device may absorb the frame,
+  // anything older would reorder its events
+  for (std::deque<Packet>::reverse_iterator i = m_pending.rbegin();
+       i != m_pending.rend(); ++i) {
+    if (i->header.device == device) {
+      if (i->header.type == SocketInputPacket::kFrame &&
+          merge_frame(*i, frame)) {
+        return;
+      } else {
+        break;
+      }
+    }
+  }
+
+  Packet packet;
+  packet.header.type = SocketInputPacket::kFrame;
+  packet.header.device = device;
+  packet.events.swap(frame);
+  queue(packet);
+}
+
+bool SocketInputSink::has_key_event(const Packet& packet) {
+  for (std::vector<struct input_event>::const_iterator ev =
+           packet.events.begin();
+       ev != packet.events.end(); ++ev) {
+    if (ev->type == EV_KEY) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SocketInputSink::merge_frame(
+    Packet& packet, const std::vector<struct input_event>& frame) {
+  std::vector<struct input_event>& events = packet.events;
+
+  // merging a key event with an earlier one of the same key would
+  // lose a press or release
+  for (std::vector<struct input_event>::const_iterator ev = frame.begin();
+       ev != frame.end(); ++ev) {
+    if (ev->type == EV_KEY) {
+      for (std::vector<struct input_event>::const_iterator old =
+               events.begin();
+           old != events.end(); ++old) {
+        if (old->type == EV_KEY && old->code == ev->code) {
+          return false;
+        }
+      }
+    }
+  }
+
+  // the SYN_REPORT of the queued frame is replaced by the new one
+  events.pop_back();
+
+  for (std::vector<struct input_event>::const_iterator ev = frame.begin();
+       ev != frame.end(); ++ev) {
+    std::vector<struct input_event>::iterator old = events.end();
+    if (ev->type == EV_ABS || ev->type == EV_REL) {
+      for (old = events.begin(); old != events.end(); ++old) {
+        if (old->type == ev->type && old->code == ev->code) {
+          break;
+        }
+      }
+    }
+
+    if (old == events.end()) {
+      events.push_back(*ev);
+    } else if (ev->type == EV_ABS) {
+      old->value = ev->value;
+      old->time = ev->time;
+    } else {
+      old->value += ev->value;
+      old->time = ev->time;
+    }
+  }
+
+  return true;
+}
+
+void SocketInputSink::schedule_flush() {
+  // while waiting for the socket to become writable the watch does
+  // the flushing
+  if (!m_flush_id && !m_writable_id) {
+    m_flush_id = g_idle_add(&SocketInputSink::on_flush_wrap, this);
+  }
+}
+
+void SocketInputSink::flush() {
+  if (m_dropped) {
+    log_warn(m_dropped << " frames dropped, consumer at " << m_path
+                       << " doesn't keep up");
+    m_dropped = 0;
+  }
+
+  struct mmsghdr msgs[kMaxBatch];
+  struct iovec iovs[kMaxBatch][2];
+
+  while (!m_pending.empty()) {
+    size_t count = std::min(m_pending.size(), kMaxBatch);
+    for (size_t i = 0; i < count; ++i) {
+      Packet& packet = m_pending[i];
+
+      iovs[i][0].iov_base = &packet.header;
+      iovs[i][0].iov_len = sizeof(packet.header);
+      if (packet.header.type == SocketInputPacket::kFrame) {
+        iovs[i][1].iov_base = packet.events.data();
+        iovs[i][1].iov_len = packet.events.size() * sizeof(struct input_event);
+      } else {
+        iovs[i][1].iov_base = &packet.payload[0];
+        iovs[i][1].iov_len = packet.payload.size();
+      }
+
+      memset(&msgs[i], 0, sizeof(msgs[i]));
+      msgs[i].msg_hdr.msg_iov = iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    int ret = sendmmsg(m_fd, msgs, static_cast<unsigned int>(count),
+                       MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        if (!m_writable_id) {
+          m_writable_id = g_io_add_watch(
+              m_io_channel,
+              static_cast<GIOCondition>(G_IO_OUT | G_IO_ERR | G_IO_HUP),
+              &SocketInputSink::on_writable_wrap, this);
+        }
+      } else if (errno != EINTR) {
+        log_error("couldn't send to " << m_path << ": " << strerror(errno));
+        disconnect();
+      }
+      return;
+    } else {
+      m_pending.erase(m_pending.begin(), m_pending.begin() + ret);
+    }
+  }
+}
+
+void SocketInputSink::disconnect() {
+  // the output goes nowhere from here on, the pipeline keeps running
+  m_pending.clear();
+  m_frames.clear();
+  close(m_fd);
+  m_fd = -1;
+}
+
+bool SocketInputSink::on_flush() {
+  m_flush_id = 0;
+  flush();
+  return false;
+}
+
+gboolean SocketInputSink::on_writable(GIOChannel* source,
+                                      GIOCondition condition) {
+  m_writable_id = 0;
+  if (m_fd >= 0) {
+    flush();
+  }
+  return FALSE;
+}
+
+/* EOF */
@@ -0,0 +1,122 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_SOCKET_INPUT_SINK_HPP
+#define HEADER_XBOXDRV_SOCKET_INPUT_SINK_HPP
+
+#include <glib.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "input_event_sink.hpp"
+
+/** The wire format of SocketInputSink, every SOCK_SEQPACKET message
+    starts with a SocketInputPacket header:
+
+    kAddDevice: followed by a struct input_id and the device name
+    kRemoveDevice: no payload
+    kFrame: followed by the struct input_event of one frame, the last
+            one is always EV_SYN SYN_REPORT */
+struct SocketInputPacket {
+  enum Type { kAddDevice, kRemoveDevice, kFrame };
+
+  uint32_t type;
+  uint32_t device;
+};
+
+/** Sends the output of LinuxUinput as SOCK_SEQPACKET messages to a
+    consumer listening on a Unix socket, so that the mapping can run
+    without /dev/uinput. Frames are queued and sent in batches once
+    per main loop iteration. When the consumer doesn't keep up, the
+    queue is held back until the socket is writable again, a frame
+    arriving meanwhile is merged into the queued frame of the same
+    device: absolute axes take the latest value, relative axes add up,
+    key events are never merged away. Once too much is queued, frames
+    without key events are dropped, frames with key events are still
+    queued. When even those pile up, the consumer is disconnected. */
+class SocketInputSink : public InputEventSink {
+ private:
+  static constexpr size_t kMaxBatch = 64;
+  static constexpr size_t kMaxPending = 4096;
+  static constexpr size_t kMaxQueued = 4 * kMaxPending;
+
+  struct Packet {
+    SocketInputPacket header;
+    std::vector<struct input_event> events;
+    std::string payload;
+  };
+
+  std::string m_path;
+  int m_fd;
+  uint32_t m_next_device;
+
+  /** frames that are still being assembled */
+  std::map<uint32_t, std::vector<struct input_event> > m_frames;
+
+  std::deque<Packet> m_pending;
+  unsigned int m_dropped;
+
+  guint m_flush_id;
+  GIOChannel* m_io_channel;
+  guint m_writable_id;
+
+ public:
+  SocketInputSink(const std::string& path);
+  ~SocketInputSink();
+
+  uint32_t add_device(const std::string& name, const struct input_id& id);
+  void remove_device(uint32_t device);
+  void send(uint32_t device, const struct input_event& ev);
+
+ private:
+  void queue(const Packet& packet);
+  void queue_frame(uint32_t device, std::vector<struct input_event>& frame);
+
+  static bool has_key_event(const Packet& packet);
+
+  /** Returns true if \a frame could be merged into \a packet */
+  static bool merge_frame(Packet& packet,
+                          const std::vector<struct input_event>& frame);
+
+  void schedule_flush();
+  void flush();
+  void disconnect();
+
+  bool on_flush();
+  static gboolean on_flush_wrap(gpointer data) {
+    return static_cast<SocketInputSink*>(data)->on_flush();
+  }
+
+  gboolean on_writable(GIOChannel* source, GIOCondition condition);
+  static gboolean on_writable_wrap(GIOChannel* source, GIOCondition condition,
+                                   gpointer userdata) {
+    return static_cast<SocketInputSink*>(userdata)->on_writable(source,
+                                                                condition);
+  }
+
+ private:
+  SocketInputSink(const SocketInputSink&);
+  SocketInputSink& operator=(const SocketInputSink&);
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,61 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "state_export.hpp"
+
+#include <new>
+
+StateExport::StateExport(const std::string& filename)
+    : m_file(filename, sizeof(ExportedState),
+             std::string(kExportedStateMagic, sizeof(kExportedStateMagic))),
+      m_state() {
+  // the file is zero filled, which is a valid state for the atomic
+  m_state = new (m_file.get_data()) ExportedState;
+  m_state->size = sizeof(ExportedState);
+  m_state->seq.store(0, std::memory_order_relaxed);
+
+  // the magic goes in last, so a reader never sees a half set up file
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(m_state->magic, kExportedStateMagic, sizeof(kExportedStateMagic));
+}
+
+StateExport::~StateExport() {}
+
+void StateExport::update(XboxGenericMsg& msg, int64_t time) {
+  uint32_t seq = m_state->seq.load(std::memory_order_relaxed);
+  m_state->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  m_state->time_usec = static_cast<uint64_t>(time / 1000);
+
+  uint32_t buttons = 0;
+  for (int btn = 1; btn < XBOX_BTN_MAX; ++btn) {
+    if (get_button(msg, static_cast<XboxButton>(btn))) {
+      buttons |= 1u << btn;
+    }
+  }
+  m_state->buttons = buttons;
+
+  for (int axis = 1; axis < XBOX_AXIS_MAX; ++axis) {
+    m_state->axes[axis] = get_axis_float(msg, static_cast<XboxAxis>(axis));
+  }
+
+  m_state->seq.store(seq + 2, std::memory_order_release);
+}
+
+/* EOF */
@@ -0,0 +1,90 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_STATE_EXPORT_HPP
+#define HEADER_XBOXDRV_STATE_EXPORT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "shared_memory_file.hpp"
+#include "xboxmsg.hpp"
+
+/** The layout of a file written by StateExport, readers map it and
+    use read_exported_state() to get a consistent copy */
+const char kExportedStateMagic[8] = {'X', 'B', 'D', 'S', 'T', 'A', 'T', '1'};
+
+struct ExportedState {
+  char magic[8];
+  uint32_t size;
+
+  /** odd while the writer is updating the state */
+  std::atomic<uint32_t> seq;
+
+  uint64_t time_usec;
+
+  /** bit (1 << XboxButton) is set while the button is pressed */
+  uint32_t buttons;
+  uint32_t padding;
+
+  /** axes as returned by get_axis_float(), in the range [-1, 1] */
+  float axes[XBOX_AXIS_MAX];
+};
+
+/** Copies the state published in \a shared to \a out, returns false
+    if the writer was busy, the caller should simply try again */
+inline bool read_exported_state(const ExportedState& shared,
+                                ExportedState* out) {
+  uint32_t seq = shared.seq.load(std::memory_order_acquire);
+  if (seq & 1) {
+    return false;
+  } else {
+    out->time_usec = shared.time_usec;
+    out->buttons = shared.buttons;
+    memcpy(out->axes, shared.axes, sizeof(out->axes));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return shared.seq.load(std::memory_order_relaxed) == seq;
+  }
+}
+
+/** Publishes the state of a controller after the modifiers ran in a
+    shared memory file, so that other processes can read the current
+    state without going through the kernel or D-Bus. Updating it is a
+    plain memory write guarded by a sequence counter, it doesn't cost
+    more with more readers. */
+class StateExport {
+ private:
+  SharedMemoryFile m_file;
+  ExportedState* m_state;
+
+ public:
+  StateExport(const std::string& filename);
+  ~StateExport();
+
+  void update(XboxGenericMsg& msg, int64_t time);
+
+ private:
+  StateExport(const StateExport&);
+  StateExport& operator=(const StateExport&);
+};
+
+#endif
+
+/* EOF */
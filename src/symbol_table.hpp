@@ -0,0 +1,75 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_SYMBOL_TABLE_HPP
+#define HEADER_XBOXDRV_SYMBOL_TABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+template <typename T>
+struct Symbol {
+  std::string_view name;
+  T value;
+};
+
+/** Sorts the given symbols by name at compile time so that they can
+    be searched with symbol_lookup() without any runtime setup */
+template <typename T, std::size_t N>
+constexpr std::array<Symbol<T>, N> make_symbol_table(
+    std::array<Symbol<T>, N> symbols) {
+  std::sort(symbols.begin(), symbols.end(),
+            [](const Symbol<T>& lhs, const Symbol<T>& rhs) {
+              return lhs.name < rhs.name;
+            });
+  return symbols;
+}
+
+/** Builds a table mapping each value to its name, when multiple
+    symbols share a value the last one wins */
+template <std::size_t Count, typename T, std::size_t N>
+constexpr std::array<std::string_view, Count> make_symbol_index(
+    const std::array<Symbol<T>, N>& symbols) {
+  std::array<std::string_view, Count> index{};
+  for (const Symbol<T>& sym : symbols) {
+    index[static_cast<std::size_t>(sym.value)] = sym.name;
+  }
+  return index;
+}
+
+/** Returns the symbol matching \a name in a table created with
+    make_symbol_table() or NULL when there is none */
+template <typename Table>
+constexpr auto symbol_lookup(const Table& table, std::string_view name)
+    -> decltype(&*table.begin()) {
+  auto it = std::lower_bound(table.begin(), table.end(), name,
+                             [](const auto& lhs, std::string_view rhs) {
+                               return lhs.name < rhs;
+                             });
+  if (it != table.end() && it->name == name) {
+    return &*it;
+  } else {
+    return nullptr;
+  }
+}
+
+#endif
+
+/* EOF */
@@ -0,0 +1,206 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <limits>
+
+TimerWheel::TimerWheel(uint64_t now) : m_slots(), m_now(now), m_count(0) {
+  for (int level = 0; level < kLevels; ++level) {
+    for (int i = 0; i < kSlots; ++i) {
+      m_slots[level][i].m_prev = &m_slots[level][i];
+      m_slots[level][i].m_next = &m_slots[level][i];
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  // leave the timers in an unscheduled state
+  for (int level = 0; level < kLevels; ++level) {
+    for (int i = 0; i < kSlots; ++i) {
+      Timer* head = &m_slots[level][i];
+      while (head->m_next != head) {
+        unlink(head->m_next);
+      }
+    }
+  }
+}
+
+void TimerWheel::add(Timer* timer, uint64_t deadline) {
+  remove(timer);
+
+  timer->m_deadline = deadline;
+  insert(timer, m_now + 1);
+  m_count += 1;
+}
+
+void TimerWheel::remove(Timer* timer) {
+  if (timer->is_scheduled()) {
+    unlink(timer);
+    m_count -= 1;
+  }
+}
+
+void TimerWheel::advance(uint64_t now) {
+  while (m_now < now) {
+    if (m_count == 0) {
+      m_now = now;
+      break;
+    }
+
+    // nothing is due and no occupied slot gets cascaded before the
+    // next event, so the ticks in between can be skipped
+    m_now = std::min(now, next_event()) - 1;
+    tick();
+  }
+}
+
+uint64_t TimerWheel::next_deadline() const {
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+
+  for (int level = 0; level < kLevels; ++level) {
+    uint64_t base = m_now >> (level * kSlotBits);
+    for (int k = 1; k <= kSlots; ++k) {
+      const Timer* head = &m_slots[level][slot_index(base + k, 0)];
+      if (head->m_next != head) {
+        if (level == 0) {
+          result = std::min(result, m_now + k);
+        } else {
+          for (const Timer* t = head->m_next; t != head; t = t->m_next) {
+            result = std::min(result, t->m_deadline);
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+void TimerWheel::tick() {
+  m_now += 1;
+
+  // when a level wraps around, move the timers of the next slot of
+  // the level above down
+  for (int level = 1; level < kLevels && slot_index(m_now, level - 1) == 0;
+       ++level) {
+    cascade(level);
+  }
+
+  // take the due timers out first, as expire() may add new ones
+  SentinelTimer due;
+  due.m_prev = &due;
+  due.m_next = &due;
+  splice(&m_slots[0][slot_index(m_now, 0)], &due);
+
+  while (due.m_next != &due) {
+    Timer* timer = due.m_next;
+    unlink(timer);
+    m_count -= 1;
+    timer->expire(m_now);
+  }
+}
+
+uint64_t TimerWheel::next_event() const {
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+
+  for (int level = 0; level < kLevels; ++level) {
+    uint64_t base = m_now >> (level * kSlotBits);
+    for (int k = 1; k <= kSlots; ++k) {
+      const Timer* head = &m_slots[level][slot_index(base + k, 0)];
+      if (head->m_next != head) {
+        // level 0 slots expire on their tick, the others get cascaded
+        // once the levels below wrap around to them
+        result = std::min(result, (base + k) << (level * kSlotBits));
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+void TimerWheel::insert(Timer* timer, uint64_t earliest) {
+  uint64_t deadline = std::max(timer->m_deadline, earliest);
+  uint64_t delta = deadline - m_now;
+
+  int level = 0;
+  while (level < kLevels - 1 &&
+         delta >= (static_cast<uint64_t>(1) << ((level + 1) * kSlotBits))) {
+    level += 1;
+  }
+
+  // deadlines beyond the range of the wheel are parked in the last
+  // slot and reinserted when that is cascaded
+  const uint64_t range = static_cast<uint64_t>(1) << (kLevels * kSlotBits);
+  if (delta >= range) {
+    deadline = m_now + range - 1;
+  }
+
+  link(&m_slots[level][slot_index(deadline, level)], timer);
+}
+
+void TimerWheel::cascade(int level) {
+  SentinelTimer pending;
+  pending.m_prev = &pending;
+  pending.m_next = &pending;
+  splice(&m_slots[level][slot_index(m_now, level)], &pending);
+
+  while (pending.m_next != &pending) {
+    Timer* timer = pending.m_next;
+    unlink(timer);
+    // the current tick is processed right after cascading, so timers
+    // due now go into its slot
+    insert(timer, m_now);
+  }
+}
+
+int TimerWheel::slot_index(uint64_t tick, int level) {
+  return static_cast<int>((tick >> (level * kSlotBits)) & (kSlots - 1));
+}
+
+void TimerWheel::link(Timer* head, Timer* timer) {
+  timer->m_prev = head->m_prev;
+  timer->m_next = head;
+  head->m_prev->m_next = timer;
+  head->m_prev = timer;
+}
+
+void TimerWheel::unlink(Timer* timer) {
+  timer->m_prev->m_next = timer->m_next;
+  timer->m_next->m_prev = timer->m_prev;
+  timer->m_prev = 0;
+  timer->m_next = 0;
+}
+
+void TimerWheel::splice(Timer* from, Timer* to) {
+  if (from->m_next != from) {
+    // append the whole list of 'from' to 'to'
+    from->m_next->m_prev = to->m_prev;
+    to->m_prev->m_next = from->m_next;
+    from->m_prev->m_next = to;
+    to->m_prev = from->m_prev;
+
+    from->m_prev = from;
+    from->m_next = from;
+  }
+}
+
+/* EOF */
@@ -0,0 +1,113 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_TIMER_WHEEL_HPP
+#define HEADER_XBOXDRV_TIMER_WHEEL_HPP
+
+#include <cstdint>
+
+/** A hierarchical timer wheel, four levels of 64 slots each. Time is
+    counted in abstract ticks, a timer on level N lands in a slot
+    covering 64^N ticks and is moved down a level when the wheel gets
+    there, so adding, removing and expiring a timer is O(1). Timers
+    are intrusive, the wheel never allocates. */
+class TimerWheel {
+ public:
+  class Timer {
+    friend class TimerWheel;
+
+   private:
+    uint64_t m_deadline;
+    Timer* m_prev;
+    Timer* m_next;
+
+   public:
+    Timer() : m_deadline(0), m_prev(0), m_next(0) {}
+    virtual ~Timer() {}
+
+    uint64_t get_deadline() const { return m_deadline; }
+    bool is_scheduled() const { return m_prev != 0; }
+
+    /** Called by TimerWheel::advance() when the deadline is reached,
+        the timer is no longer scheduled at that point and may add
+        itself again */
+    virtual void expire(uint64_t now) = 0;
+
+   private:
+    Timer(const Timer&);
+    Timer& operator=(const Timer&);
+  };
+
+ private:
+  static const int kSlotBits = 6;
+  static const int kSlots = 1 << kSlotBits;
+  static const int kLevels = 4;
+
+  // each slot is a circular list headed by a sentinel
+  class SentinelTimer : public Timer {
+   public:
+    void expire(uint64_t now) {}
+  };
+
+  SentinelTimer m_slots[kLevels][kSlots];
+  uint64_t m_now;
+  int m_count;
+
+ public:
+  TimerWheel(uint64_t now = 0);
+  ~TimerWheel();
+
+  uint64_t get_now() const { return m_now; }
+  bool empty() const { return m_count == 0; }
+
+  /** Schedules \a timer at \a deadline, a deadline that is already
+      due expires on the next advance() */
+  void add(Timer* timer, uint64_t deadline);
+  void remove(Timer* timer);
+
+  /** Moves the wheel to \a now and expires all timers that are due */
+  void advance(uint64_t now);
+
+  /** Returns the earliest tick at which advance() has work to do,
+      only valid when the wheel isn't empty */
+  uint64_t next_deadline() const;
+
+ private:
+  /** Moves the wheel forward by a single tick */
+  void tick();
+
+  /** Returns the earliest tick at which a timer expires or an
+      occupied slot is cascaded */
+  uint64_t next_event() const;
+
+  void insert(Timer* timer, uint64_t earliest);
+  void cascade(int level);
+
+  static int slot_index(uint64_t tick, int level);
+  static void link(Timer* head, Timer* timer);
+  static void unlink(Timer* timer);
+  static void splice(Timer* from, Timer* to);
+
+ private:
+  TimerWheel(const TimerWheel&);
+  TimerWheel& operator=(const TimerWheel&);
+};
+
+#endif
+
+/* EOF */
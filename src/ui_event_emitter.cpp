@@ -18,9 +18,26 @@
 
 #include "ui_event_emitter.hpp"
 
+#include <linux/input.h>
+
 #include <cassert>
 
-#include "log.hpp"
 #include "uinput.hpp"
 
+UIEventEmitter::UIEventEmitter(UInput& uinput, int collector, int type)
+    : m_uinput(uinput), m_collector(collector), m_type(type), m_value(0) {}
+
+void UIEventEmitter::send(int value) {
+  if (m_type == EV_REL) {
+    m_uinput.collect(m_collector, value);
+  } else {
+    assert(m_type != EV_KEY || value == 0 || value == 1);
+
+    if (m_value != value) {
+      m_value = value;
+      m_uinput.collect(m_collector, value);
+    }
+  }
+}
+
 /* EOF */
@@ -24,28 +24,32 @@
 
 class UInput;
 class UIEventEmitter;
-class UIEventCollector;
 
 typedef std::shared_ptr<UIEventEmitter> UIEventEmitterPtr;
 
+/** The output of a single event handler, all emitters for the same
+    device, type and code share one collector in UInput, which merges
+    their values. Emitters only hold the index of their collector, so
+    sending doesn't go through virtual calls or device lookups. */
 class UIEventEmitter {
+ private:
+  UInput& m_uinput;
+  int m_collector;
+  int m_type;
+  int m_value;
+
  public:
-  UIEventEmitter() {}
-  virtual ~UIEventEmitter() {}
+  UIEventEmitter(UInput& uinput, int collector, int type);
 
-  virtual void send(int value) = 0;
+  /** EV_ABS and EV_KEY are only passed on when they changed, EV_REL
+      always */
+  void send(int value);
 
  private:
   UIEventEmitter(const UIEventEmitter&);
   UIEventEmitter& operator=(const UIEventEmitter&);
 };
 
-class UIRelEmitter {
- private:
- public:
-  UIRelEmitter();
-};
-
 #endif
 
 /* EOF */
@@ -18,9 +18,9 @@
 
 #include "uinput.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
-#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -28,9 +28,36 @@
 #include "helper.hpp"
 #include "log.hpp"
 #include "raise_exception.hpp"
-#include "ui_abs_event_collector.hpp"
-#include "ui_key_event_collector.hpp"
-#include "ui_rel_event_collector.hpp"
+#include "scheduling.hpp"
+
+#ifndef REL_WHEEL_HI_RES
+#define REL_WHEEL_HI_RES 0x0b
+#define REL_HWHEEL_HI_RES 0x0c
+#endif
+
+namespace {
+
+// fixed by the kernel, see Documentation/input/event-codes.rst
+const int kHiResPerDetent = 120;
+
+// upper limit of threads creating devices, most of the time is spent
+// waiting for the kernel and udev, not on the CPU
+const unsigned int kMaxCreators = 8;
+
+int hi_res_code(int code) {
+  switch (code) {
+    case REL_WHEEL:
+      return REL_WHEEL_HI_RES;
+
+    case REL_HWHEEL:
+      return REL_HWHEEL_HI_RES;
+
+    default:
+      return -1;
+  }
+}
+
+}  // namespace
 
 struct input_id UInput::parse_input_id(const std::string& str) {
   struct input_id usbid;
@@ -85,30 +112,64 @@ uint32_t UInput::parse_device_id(const std::string& str) {
   return UInput::create_device_id(slot_id, device_id);
 }
 
-UInput::UInput(bool extra_events)
+UInput::UInput(bool extra_events, int rel_rate, bool wheel_hi_res)
     : m_uinput_devs(),
       m_device_names(),
       m_device_usbids(),
       m_collectors(),
-      m_rel_repeat_lst(),
+      m_collector_index(),
+      m_devices(),
+      m_creators(),
+      m_create_queue(),
+      m_create_next(0),
+      m_creators_running(0),
+      m_create_mutex(),
+      m_create_error(),
+      m_created_cb(),
+      m_dirty(),
+      m_events_collected(0),
+      m_events_written(0),
+      m_rel_repeats(),
+      m_active_rel_repeats(0),
       m_extra_events(extra_events),
+      m_rel_rate(rel_rate),
+      m_wheel_hi_res(wheel_hi_res),
       m_timeout_id(),
-      m_timer(g_timer_new()) {
-  // FIXME: hardcoded timeout is kind of evil
-  // FIXME: would be nicer if UInput didn't depend on glib
-  m_timeout_id = g_timeout_add(10, &UInput::on_timeout_wrap, this);
-}
+      m_rel_time(get_time_nsec()) {}
 
 UInput::~UInput() {
-  g_source_remove(m_timeout_id);
-  g_timer_destroy(m_timer);
+  // the devices must not go away while they are being created
+  for (std::vector<std::thread>::iterator i = m_creators.begin();
+       i != m_creators.end(); ++i) {
+    i->join();
+  }
+
+  if (m_timeout_id) {
+    g_source_remove(m_timeout_id);
+  }
+
+  if (m_events_collected > 0) {
+    log_info("uinput: " << m_events_collected << " events, "
+                        << m_events_written << " written, "
+                        << (m_events_collected - m_events_written) * 100 /
+                               m_events_collected
+                        << "% deduplicated");
+  }
 }
 
 bool UInput::on_timeout() {
-  int msec_delta = static_cast<int>(g_timer_elapsed(m_timer, NULL) * 1000.0f);
-  g_timer_reset(m_timer);
-  update(msec_delta);
-  return true;  // do not remove the callback
+  int64_t now = get_time_nsec();
+  int64_t nsec_delta = now - m_rel_time;
+  advance_rel_repeats(now);
+  update(nsec_delta);
+  sync();
+
+  if (m_active_rel_repeats == 0) {
+    m_timeout_id = 0;
+    return false;
+  } else {
+    return true;
+  }
 }
 
 struct input_id UInput::get_device_usbid(uint32_t device_id) const {
@@ -276,6 +337,9 @@ UIEventEmitterPtr UInput::add_key(uint32_t device_id, int ev_code) {
 UIEventEmitterPtr UInput::add_rel(uint32_t device_id, int ev_code) {
   LinuxUinput* dev = create_uinput_device(device_id);
   dev->add_rel(ev_code);
+  if (m_wheel_hi_res && hi_res_code(ev_code) != -1) {
+    dev->add_rel(hi_res_code(ev_code));
+  }
 
   return create_emitter(device_id, EV_REL, ev_code);
 }
@@ -294,120 +358,382 @@ void UInput::add_ff(uint32_t device_id, uint16_t code) {
 }
 
 UIEventEmitterPtr UInput::create_emitter(int device_id, int type, int code) {
-  // search for an already existing emitter
-  for (Collectors::iterator i = m_collectors.begin(); i != m_collectors.end();
+  assert(type == EV_ABS || type == EV_KEY || type == EV_REL);
+
+  // the type and code fit into one int, as codes are below 0x300
+  std::pair<uint32_t, int> key(device_id, (type << 16) | code);
+  std::map<std::pair<uint32_t, int>, int>::iterator it =
+      m_collector_index.find(key);
+
+  int idx;
+  if (it != m_collector_index.end()) {
+    idx = it->second;
+  } else {
+    Collector collector;
+    collector.device_id = device_id;
+    collector.type = type;
+    collector.code = code;
+    collector.uinput = 0;
+    collector.emitters = 0;
+    collector.pressed = 0;
+    collector.value = 0;
+    collector.pending = 0;
+    collector.dirty = false;
+    m_collectors.push_back(collector);
+
+    idx = static_cast<int>(m_collectors.size() - 1);
+    m_collector_index[key] = idx;
+  }
+
+  m_collectors[idx].emitters += 1;
+  return UIEventEmitterPtr(new UIEventEmitter(*this, idx, type));
+}
+
+void UInput::reuse_devices(const UInput& other) {
+  for (UInputDevs::iterator i = m_uinput_devs.begin(); i != m_uinput_devs.end();
        ++i) {
-    if (static_cast<int>((*i)->get_device_id()) == device_id &&
-        (*i)->get_type() == type && (*i)->get_code() == code) {
-      return (*i)->create_emitter();
+    UInputDevs::const_iterator it = other.m_uinput_devs.find(i->first);
+    if (it != other.m_uinput_devs.end() && it->second->is_finished()) {
+      i->second->add_required_events();
+      if (i->second->has_same_capabilities(*it->second)) {
+        log_debug("reusing uinput device: " << i->first);
+        i->second = it->second;
+      } else {
+        log_info("uinput device " << i->first
+                                  << " changed, it will be recreated");
+      }
     }
   }
+}
 
-  // no emitter found, create a new one
-  switch (type) {
-    case EV_ABS: {
-      UIEventCollectorPtr collector(
-          new UIAbsEventCollector(*this, device_id, type, code));
-      m_collectors.push_back(collector);
-      return collector->create_emitter();
+void UInput::finish() {
+  assert(m_creators.empty());
+
+  // opening /dev/uinput is cheap and fails for all devices alike, so
+  // it is done here where the error can be reported directly, the
+  // queue is in device_id order so that lower slots come first
+  for (UInputDevs::iterator i = m_uinput_devs.begin(); i != m_uinput_devs.end();
+       ++i) {
+    if (!i->second->is_finished()) {
+      i->second->start();
+      if (!i->second->is_created()) {
+        m_create_queue.push_back(i->second);
+      }
     }
+  }
 
-    case EV_KEY: {
-      UIEventCollectorPtr collector(
-          new UIKeyEventCollector(*this, device_id, type, code));
-      m_collectors.push_back(collector);
-      return collector->create_emitter();
+  if (!m_create_queue.empty()) {
+    unsigned int num_creators =
+        std::min(std::max(std::thread::hardware_concurrency(), 1u),
+                 kMaxCreators);
+    num_creators = std::min(num_creators,
+                            static_cast<unsigned int>(m_create_queue.size()));
+
+    log_debug("creating " << m_create_queue.size() << " uinput devices with "
+                          << num_creators << " threads");
+    m_creators_running = num_creators;
+    for (unsigned int i = 0; i < num_creators; ++i) {
+      m_creators.push_back(std::thread(&UInput::run_creator, this));
     }
+  }
+
+  // resolved once here, so sending doesn't need a device lookup
+  m_devices.clear();
+  for (UInputDevs::iterator i = m_uinput_devs.begin(); i != m_uinput_devs.end();
+       ++i) {
+    m_devices.push_back(i->second.get());
+  }
+
+  for (std::vector<Collector>::iterator i = m_collectors.begin();
+       i != m_collectors.end(); ++i) {
+    i->uinput = get_uinput(i->device_id);
+  }
+
+  for (std::vector<RelRepeat>::iterator i = m_rel_repeats.begin();
+       i != m_rel_repeats.end(); ++i) {
+    i->uinput = get_uinput(i->code.get_device_id());
+  }
+}
+
+void UInput::run_creator() {
+  setup_helper_thread_scheduling();
 
-    case EV_REL: {
-      UIEventCollectorPtr collector(
-          new UIRelEventCollector(*this, device_id, type, code));
-      m_collectors.push_back(collector);
-      return collector->create_emitter();
+  for (;;) {
+    size_t idx = m_create_next++;
+    if (idx >= m_create_queue.size()) {
+      if (--m_creators_running == 0 && m_created_cb) {
+        m_created_cb();
+      }
+      return;
     }
 
-    default:
-      assert(!"unknown type");
-      break;
+    try {
+      m_create_queue[idx]->create();
+    } catch (const std::exception& err) {
+      log_error(err.what());
+
+      std::lock_guard<std::mutex> lock(m_create_mutex);
+      if (!m_create_error) {
+        m_create_error = std::current_exception();
+      }
+    }
   }
 }
 
-void UInput::finish() {
-  for (UInputDevs::iterator i = m_uinput_devs.begin(); i != m_uinput_devs.end();
-       ++i) {
-    i->second->finish();
+void UInput::wait_for_devices() {
+  for (std::vector<std::thread>::iterator i = m_creators.begin();
+       i != m_creators.end(); ++i) {
+    i->join();
+  }
+  m_creators.clear();
+
+  // stays set, a UInput with missing devices is broken for good
+  if (m_create_error) {
+    std::rethrow_exception(m_create_error);
   }
 }
 
+void UInput::set_created_cb(const std::function<void()>& callback) {
+  assert(m_creators.empty());
+  m_created_cb = callback;
+}
+
+std::vector<std::string> UInput::get_devnodes(uint16_t slot_id) const {
+  std::vector<std::string> devnodes;
+  for (UInputDevs::const_iterator i = m_uinput_devs.begin();
+       i != m_uinput_devs.end(); ++i) {
+    if (get_slot_id(i->first) == slot_id) {
+      const std::vector<std::string>& nodes = i->second->get_devnodes();
+      devnodes.insert(devnodes.end(), nodes.begin(), nodes.end());
+    }
+  }
+  return devnodes;
+}
+
 void UInput::send(uint32_t device_id, int ev_type, int ev_code, int value) {
-  get_uinput(device_id)->send(ev_type, ev_code, value);
-}
-
-void UInput::update(int msec_delta) {
-  for (std::map<UIEvent, RelRepeat>::iterator i = m_rel_repeat_lst.begin();
-       i != m_rel_repeat_lst.end(); ++i) {
-    i->second.time_count += msec_delta;
-
-    // FIXME: shouldn't send out events multiple times, but accumulate
-    // them instead and send out only once
-    while (i->second.time_count >= i->second.repeat_interval) {
-      // value can be float, but be can only send out int, so keep
-      // track of the rest we don't send
-      int i_value = static_cast<int>(i->second.value + truncf(i->second.rest));
-      i->second.rest -= truncf(i->second.rest);
-      i->second.rest += i->second.value - truncf(i->second.value);
-
-      get_uinput(i->second.code.get_device_id())
-          ->send(EV_REL, i->second.code.code, i_value);
-      i->second.time_count -= i->second.repeat_interval;
+  LinuxUinput* uinput = get_uinput(device_id);
+  uinput->send(ev_type, ev_code, value);
+
+  // readers of a hi-res capable device ignore the low-res wheel
+  if (m_wheel_hi_res && ev_type == EV_REL && hi_res_code(ev_code) != -1) {
+    uinput->send(EV_REL, hi_res_code(ev_code), value * kHiResPerDetent);
+  }
+}
+
+void UInput::collect(int collector, int value) {
+  Collector& c = m_collectors[collector];
+  m_events_collected += 1;
+
+  switch (c.type) {
+    case EV_KEY:
+      // a key is down while any of its emitters holds it down
+      if (value) {
+        if (c.pressed >= c.emitters) {
+          log_error("got press event while all emitter where already pressed");
+        }
+        c.pressed += 1;
+      } else {
+        if (c.pressed <= 0) {
+          log_error("got release event while collector was in release state");
+        }
+        c.pressed -= 1;
+      }
+
+      // written right away, as a press and release within one frame
+      // must not cancel out, a device that is still being created
+      // gets the state on a later sync()
+      value = (c.pressed > 0) ? 1 : 0;
+      if (value != c.value && c.uinput->is_created()) {
+        c.value = value;
+        write_collector(c, value);
+      }
+      break;
+
+    case EV_ABS:
+      c.pending = value;
+      break;
+
+    case EV_REL:
+      c.pending += value;
+      break;
+  }
+
+  if ((c.type != EV_KEY || !c.uinput->is_created()) && !c.dirty) {
+    c.dirty = true;
+    m_dirty.push_back(collector);
+  }
+}
+
+void UInput::write_collector(Collector& c, int value) {
+  m_events_written += 1;
+  c.uinput->send(c.type, c.code, value);
+
+  // readers of a hi-res capable device ignore the low-res wheel
+  if (m_wheel_hi_res && c.type == EV_REL && hi_res_code(c.code) != -1) {
+    c.uinput->send(EV_REL, hi_res_code(c.code), value * kHiResPerDetent);
+  }
+}
+
+void UInput::update(int64_t nsec_delta) {
+  for (std::vector<RelRepeat>::iterator i = m_rel_repeats.begin();
+       i != m_rel_repeats.end(); ++i) {
+    // sends what accumulated since the last tick as one event
+    flush_rel_repeat(*i);
+    if (i->velocity == 0.0) {
+      i->rest = 0.0;
     }
   }
 
   for (UInputDevs::iterator i = m_uinput_devs.begin(); i != m_uinput_devs.end();
        ++i) {
-    i->second->update(msec_delta);
+    i->second->update(static_cast<int>(nsec_delta / 1000000));
   }
 }
 
 void UInput::sync() {
-  for (Collectors::iterator i = m_collectors.begin(); i != m_collectors.end();
+  std::vector<int>::iterator keep = m_dirty.begin();
+  for (std::vector<int>::iterator i = m_dirty.begin(); i != m_dirty.end();
        ++i) {
+    Collector& c = m_collectors[*i];
+
+    if (!c.uinput->is_created()) {
+      if (c.type == EV_REL) {
+        // movement from before the device existed is stale
+        c.pending = 0;
+        c.dirty = false;
+      } else {
+        // c.value stays at what the kernel last got, so the state is
+        // written once the device exists
+        *keep++ = *i;
+      }
+      continue;
+    }
+
+    c.dirty = false;
+
+    if (c.type == EV_KEY) {
+      int value = (c.pressed > 0) ? 1 : 0;
+      if (value != c.value) {
+        c.value = value;
+        write_collector(c, value);
+      }
+    } else if (c.type == EV_ABS) {
+      if (c.pending != c.value) {
+        c.value = c.pending;
+        write_collector(c, c.value);
+      }
+    } else if (c.pending != 0) {  // EV_REL
+      write_collector(c, c.pending);
+      c.pending = 0;
+    }
+  }
+  m_dirty.erase(keep, m_dirty.end());
+
+  // LinuxUinput only adds a SYN_REPORT when something was written
+  for (std::vector<LinuxUinput*>::iterator i = m_devices.begin();
+       i != m_devices.end(); ++i) {
     (*i)->sync();
   }
+}
 
-  for (UInputDevs::iterator i = m_uinput_devs.begin(); i != m_uinput_devs.end();
+int UInput::add_rel_repeat(const UIEvent& code) {
+  for (std::vector<RelRepeat>::size_type i = 0; i < m_rel_repeats.size();
        ++i) {
-    i->second->sync();
+    if (m_rel_repeats[i].code.get_device_id() == code.get_device_id() &&
+        m_rel_repeats[i].code.code == code.code) {
+      return static_cast<int>(i);
+    }
   }
+
+  RelRepeat rel_rep;
+  rel_rep.code = code;
+  rel_rep.uinput = 0;
+  rel_rep.hi_res_code = m_wheel_hi_res ? hi_res_code(code.code) : -1;
+  rel_rep.velocity = 0.0;
+  rel_rep.rest = 0.0;
+  rel_rep.detent_rest = 0;
+  m_rel_repeats.push_back(rel_rep);
+  return static_cast<int>(m_rel_repeats.size() - 1);
 }
 
-void UInput::send_rel_repetitive(const UIEvent& code, float value,
+void UInput::send_rel_repetitive(int rel_repeat, float value,
                                  int repeat_interval) {
-  if (repeat_interval < 0) {  // remove rel_repeats from list
-    // FIXME: should send the last value still in the repeater
-    m_rel_repeat_lst.erase(code);
-    // no need to send a event for rel, as it defaults to 0 anyway
-  } else {  // add rel_repeats to list
-    std::map<UIEvent, RelRepeat>::iterator it = m_rel_repeat_lst.find(code);
-
-    if (it == m_rel_repeat_lst.end()) {
-      RelRepeat rel_rep;
-      rel_rep.code = code;
-      rel_rep.value = value;
-      rel_rep.rest = 0.0f;
-      rel_rep.time_count = 0;
-      rel_rep.repeat_interval = repeat_interval;
-      m_rel_repeat_lst.insert(std::pair<UIEvent, RelRepeat>(code, rel_rep));
-
-      // Send the event once
-      get_uinput(code.get_device_id())->send(EV_REL, code.code, value);
-    } else {
-      // FIXME: send old value, store new value for rest
+  RelRepeat& rel_rep = m_rel_repeats[rel_repeat];
 
-      it->second.code = code;
-      it->second.value = value;
-      // it->second.time_count = do not touch this
-      it->second.repeat_interval = repeat_interval;
+  if (repeat_interval < 0) {
+    set_rel_velocity(rel_repeat, 0.0);
+  } else {
+    if (rel_rep.velocity == 0.0) {
+      // send the event once right away, the rest is carried over
+      rel_rep.rest += (rel_rep.hi_res_code == -1) ? value
+                                                  : value * kHiResPerDetent;
+      flush_rel_repeat(rel_rep);
+    }
+
+    set_rel_velocity(rel_repeat,
+                     value * 1000.0 / std::max(repeat_interval, 1));
+  }
+}
+
+void UInput::set_rel_velocity(int rel_repeat, double velocity) {
+  RelRepeat& rel_rep = m_rel_repeats[rel_repeat];
+
+  if (velocity != rel_rep.velocity) {
+    // the old velocity applies up to now
+    advance_rel_repeats(get_time_nsec());
+
+    if (rel_rep.velocity == 0.0) {
+      m_active_rel_repeats += 1;
+
+      // the timeout only runs while there is something to repeat
+      if (!m_timeout_id) {
+        // FIXME: would be nicer if UInput didn't depend on glib
+        m_timeout_id = g_timeout_add(std::max(1000 / m_rel_rate, 1),
+                                     &UInput::on_timeout_wrap, this);
+      }
+    } else if (velocity == 0.0) {
+      // what accumulated so far is still sent on the next tick
+      m_active_rel_repeats -= 1;
+    }
+
+    rel_rep.velocity = velocity;
+  }
+}
+
+void UInput::advance_rel_repeats(int64_t now) {
+  double seconds = static_cast<double>(now - m_rel_time) / 1000000000.0;
+  m_rel_time = now;
+
+  for (std::vector<RelRepeat>::iterator i = m_rel_repeats.begin();
+       i != m_rel_repeats.end(); ++i) {
+    if (i->velocity != 0.0) {
+      if (i->hi_res_code == -1) {
+        i->rest += i->velocity * seconds;
+      } else {
+        i->rest += i->velocity * kHiResPerDetent * seconds;
+      }
+    }
+  }
+}
+
+void UInput::flush_rel_repeat(RelRepeat& rel_rep) {
+  double value = trunc(rel_rep.rest);
+  if (value != 0.0) {
+    rel_rep.rest -= value;
+
+    if (rel_rep.hi_res_code == -1) {
+      rel_rep.uinput->send(EV_REL, rel_rep.code.code, static_cast<int>(value));
+    } else {
+      rel_rep.uinput->send(EV_REL, rel_rep.hi_res_code,
+                           static_cast<int>(value));
+
+      // the low-res wheel moves once a full detent is reached
+      rel_rep.detent_rest += static_cast<int>(value);
+      int detents = rel_rep.detent_rest / kHiResPerDetent;
+      if (detents != 0) {
+        rel_rep.detent_rest -= detents * kHiResPerDetent;
+        rel_rep.uinput->send(EV_REL, rel_rep.code.code, detents);
+      }
     }
   }
 }
@@ -446,26 +772,4 @@ void UInput::set_ff_gain(int device_id, int gain) {
   get_uinput(device_id)->set_ff_gain(gain);
 }
 
-int UInput::find_jsdev_number() {
-  for (int i = 0;; ++i) {
-    char filename1[32];
-    char filename2[32];
-
-    sprintf(filename1, "/dev/input/js%d", i);
-    sprintf(filename2, "/dev/js%d", i);
-
-    if (access(filename1, F_OK) != 0 && access(filename2, F_OK) != 0) return i;
-  }
-}
-
-int UInput::find_evdev_number() {
-  for (int i = 0;; ++i) {
-    char filename[32];
-
-    sprintf(filename, "/dev/input/event%d", i);
-
-    if (access(filename, F_OK) != 0) return i;
-  }
-}
-
 /* EOF */
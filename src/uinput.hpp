@@ -21,13 +21,19 @@
 
 #include <glib.h>
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "axis_event.hpp"
 #include "linux_uinput.hpp"
-#include "ui_event_collector.hpp"
 #include "ui_event_emitter.hpp"
 
 struct Xbox360Msg;
@@ -61,34 +67,82 @@ class UInput {
   typedef std::map<uint32_t, struct input_id> DeviceUSBId;
   DeviceUSBId m_device_usbids;
 
-  typedef std::vector<UIEventCollectorPtr> Collectors;
-  Collectors m_collectors;
+  /** Merges the output of all emitters for one device, type and
+      code */
+  struct Collector {
+    uint32_t device_id;
+    int type;
+    int code;
+    LinuxUinput* uinput;  /// set by finish()
+    int emitters;
+    int pressed;  /// number of emitters holding an EV_KEY down
+    int value;    /// last value written
+    int pending;  /// EV_ABS value or sum of EV_REL to write on sync()
+    bool dirty;   /// in m_dirty
+  };
 
+  /** indexed by UIEventEmitter, m_collector_index is only used while
+      setting up */
+  std::vector<Collector> m_collectors;
+  std::map<std::pair<uint32_t, int>, int> m_collector_index;
+
+  /** the devices of m_uinput_devs after finish(), for syncing */
+  std::vector<LinuxUinput*> m_devices;
+
+  /** threads creating the devices of m_create_queue in the kernel,
+      each takes the next device from m_create_next */
+  std::vector<std::thread> m_creators;
+  std::vector<std::shared_ptr<LinuxUinput> > m_create_queue;
+  std::atomic<size_t> m_create_next;
+  std::atomic<unsigned int> m_creators_running;
+  std::mutex m_create_mutex;
+  std::exception_ptr m_create_error;
+  /** called from the creator thread that finishes last */
+  std::function<void()> m_created_cb;
+
+  /** collectors with EV_ABS or EV_REL pending for the next sync(),
+      and collectors of any type whose device is still being created */
+  std::vector<int> m_dirty;
+
+  /** events passed to collect() and the ones that were written */
+  uint64_t m_events_collected;
+  uint64_t m_events_written;
+
+  /** A rel event sent continuously at a given velocity, used for
+      mouse emulation and repeated scrolling */
   struct RelRepeat {
     UIEvent code;
-    float value;
-    float rest;
-    int time_count;
-    int repeat_interval;
+    LinuxUinput* uinput;  /// set by finish()
+    int hi_res_code;      /// REL_WHEEL_HI_RES or similar, -1 if none
+    double velocity;      /// in events per second
+    /** the part of the movement that wasn't sent yet, in units of
+        hi_res_code if set, kept as double so that no rounding error
+        builds up */
+    double rest;
+    /** hi-res units sent, but not yet as a full wheel detent */
+    int detent_rest;
   };
 
-  std::map<UIEvent, RelRepeat> m_rel_repeat_lst;
+  /** indexed by the handles returned from add_rel_repeat() */
+  std::vector<RelRepeat> m_rel_repeats;
+  int m_active_rel_repeats;
 
   bool m_extra_events;
+  int m_rel_rate;
+  bool m_wheel_hi_res;
 
+  /** only set while a rel repeat is active */
   guint m_timeout_id;
-  GTimer* m_timer;
+  /** CLOCK_MONOTONIC up to which the rel repeats have advanced */
+  int64_t m_rel_time;
 
  public:
-  UInput(bool extra_events);
+  /** \a rel_rate is the number of times per second rel repeats are
+      sent, \a wheel_hi_res adds REL_WHEEL_HI_RES and
+      REL_HWHEEL_HI_RES to devices that have the low-res wheel */
+  UInput(bool extra_events, int rel_rate, bool wheel_hi_res);
   ~UInput();
 
-  /** guess the number of the next unused /dev/input/jsX device */
-  static int find_jsdev_number();
-
-  /** guess the number of the next unused /dev/input/eventX device */
-  static int find_evdev_number();
-
   void set_device_names(const std::map<uint32_t, std::string>& device_names);
   void set_device_usbids(
       const std::map<uint32_t, struct input_id>& device_usbids);
@@ -104,24 +158,75 @@ class UInput {
   UIEventEmitterPtr add_key(uint32_t device_id, int ev_code);
   void add_ff(uint32_t device_id, uint16_t code);
 
-  /** needs to be called to finish device creation and create the
-      device in the kernel */
+  /** Registers \a code for send_rel_repetitive() and
+      set_rel_velocity() and returns the handle for it, handlers using
+      the same code share one */
+  int add_rel_repeat(const UIEvent& code);
+
+  /** Takes over the already created devices of \a other that have
+      the same capabilities as the ones set up here, so that they
+      don't have to be destroyed and recreated, must be called before
+      finish() */
+  void reuse_devices(const UInput& other);
+
+  /** needs to be called to finish device creation, the devices are
+      created in the kernel by a pool of threads in the background,
+      each device starts working as soon as it exists */
   void finish();
+
+  /** Blocks until all devices exist in the kernel, throws if one of
+      them couldn't be created */
+  void wait_for_devices();
+
+  /** \a callback is called once the devices of finish() are created
+      or failed, from one of the creator threads, so it must only
+      hand over to the main loop, e.g. with g_idle_add() */
+  void set_created_cb(const std::function<void()>& callback);
   /** @} */
 
+  /** The device nodes of all devices of slot \a slot_id, as reported
+      by the kernel, only valid after finish() */
+  std::vector<std::string> get_devnodes(uint16_t slot_id) const;
+
   /** Send events to the kernel
       @{*/
   void send(uint32_t device_id, int ev_type, int ev_code, int value);
-  void send_rel_repetitive(const UIEvent& code, float value,
-                           int repeat_interval);
+  /** Sends \a value every \a repeat_interval msec, spread evenly
+      over the ticks in between, a negative \a repeat_interval stops
+      the repetition */
+  void send_rel_repetitive(int rel_repeat, float value, int repeat_interval);
+
+  /** Moves continuously at \a velocity events per second, the
+      movement is integrated with nanosecond precision and sent at the
+      rel rate, 0 stops it */
+  void set_rel_velocity(int rel_repeat, double velocity);
+
+  /** Sends \a value from an emitter through collector \a collector,
+      EV_KEY is written right away, EV_ABS and EV_REL are held back
+      until sync(), so that only the last EV_ABS value and the sum of
+      EV_REL are written and EV_ABS is only written if it changed.
+      While the device is still being created, EV_KEY and EV_ABS wait
+      for the first sync() after it exists and EV_REL is dropped. */
+  void collect(int collector, int value);
 
   /** should be called to signal that all events of the current frame
-      have been send */
+      have been send, devices that didn't get any events don't get a
+      SYN_REPORT */
   void sync();
   /** @} */
 
  private:
-  void update(int msec_delta);
+  void update(int64_t nsec_delta);
+
+  void write_collector(Collector& c, int value);
+
+  void run_creator();
+
+  /** integrates the velocity of the rel repeats up to \a now */
+  void advance_rel_repeats(int64_t now);
+
+  /** sends the whole events accumulated in \a rel_rep */
+  void flush_rel_repeat(RelRepeat& rel_rep);
 
   /** create a LinuxUinput with the given device_id, if some already
       exist return a pointer to it */
@@ -259,13 +259,17 @@ void UInputConfig::send(Playstation3USBMsg& msg) {
   send_axis(XBOX_AXIS_WHITE, msg.a_r1);
 }
 
-void UInputConfig::update(int msec_delta) {
-  m_btn_map.update(m_uinput, msec_delta);
-  m_axis_map.update(m_uinput, msec_delta);
+void UInputConfig::update(int64_t nsec_delta) {
+  m_btn_map.update(m_uinput, nsec_delta);
+  m_axis_map.update(m_uinput, nsec_delta);
 
   m_uinput.sync();
 }
 
+bool UInputConfig::needs_update() const {
+  return m_btn_map.needs_update() || m_axis_map.needs_update();
+}
+
 void UInputConfig::send_button(XboxButton code, bool value) {
   if (button_state[code] != value) {
     button_state[code] = value;
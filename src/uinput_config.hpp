@@ -45,7 +45,10 @@ class UInputConfig {
                const UInputOptions& opts);
 
   void send(XboxGenericMsg& msg);
-  void update(int msec_delta);
+  void update(int64_t nsec_delta);
+
+  /** Returns true while update() has to be called periodically */
+  bool needs_update() const;
 
   void reset_all_outputs();
 
@@ -20,7 +20,10 @@
 
 #include <cstring>
 
+#include "controller.hpp"
+#include "linux_uinput.hpp"
 #include "log.hpp"
+#include "state_export.hpp"
 #include "uinput.hpp"
 
 UInputMessageProcessor::UInputMessageProcessor(UInput& uinput,
@@ -32,17 +35,21 @@ UInputMessageProcessor::UInputMessageProcessor(UInput& uinput,
       m_config_toggle_button(opts.config_toggle_button),
       m_rumble_gain(opts.rumble_gain),
       m_rumble_test(opts.rumble),
-      m_controller() {
+      m_controller(),
+      m_state_export() {
   memset(&m_oldmsg, 0, sizeof(m_oldmsg));
 }
 
 UInputMessageProcessor::~UInputMessageProcessor() {}
 
-void UInputMessageProcessor::send(const XboxGenericMsg& msg_in,
-                                  int msec_delta) {
+void UInputMessageProcessor::send(const XboxGenericMsg& msg_in, int64_t time,
+                                  int64_t nsec_delta) {
   if (!m_config->empty()) {
     XboxGenericMsg msg = msg_in;
 
+    // events written below carry the time the report arrived
+    LinuxUinput::set_event_time(time);
+
     if (m_rumble_test) {
       log_debug("rumble: " << get_axis(msg, XBOX_AXIS_LT) << " "
                            << get_axis(msg, XBOX_AXIS_RT));
@@ -70,10 +77,10 @@ void UInputMessageProcessor::send(const XboxGenericMsg& msg_in,
     for (std::vector<ModifierPtr>::iterator i =
              m_config->get_config()->get_modifier().begin();
          i != m_config->get_config()->get_modifier().end(); ++i) {
-      (*i)->update(msec_delta, msg);
+      (*i)->update(nsec_delta, msg);
     }
 
-    m_config->get_config()->get_uinput().update(msec_delta);
+    m_config->get_config()->get_uinput().update(nsec_delta);
 
     // send current Xbox state to uinput
     if (memcmp(&msg, &m_oldmsg, sizeof(XboxGenericMsg)) != 0) {
@@ -84,7 +91,44 @@ void UInputMessageProcessor::send(const XboxGenericMsg& msg_in,
       m_oldmsg = msg;
 
       m_config->get_config()->get_uinput().send(msg);
+
+      if (m_state_export) {
+        m_state_export->update(msg, time);
+      }
     }
+
+    LinuxUinput::set_event_time(0);
+  }
+}
+
+void UInputMessageProcessor::send_keys(const std::vector<ControllerKey>& keys,
+                                       int64_t time) {
+  LinuxUinput::set_event_time(time);
+
+  for (std::vector<ControllerKey>::const_iterator i = keys.begin();
+       i != keys.end(); ++i) {
+    m_config->send_key(i->code, i->value);
+  }
+
+  // all keys of a report go out in one frame
+  m_uinput.sync();
+
+  LinuxUinput::set_event_time(0);
+}
+
+bool UInputMessageProcessor::needs_update() const {
+  if (m_config->empty()) {
+    return false;
+  } else {
+    ControllerConfigPtr config = m_config->get_config();
+    for (std::vector<ModifierPtr>::const_iterator i =
+             config->get_modifier().begin();
+         i != config->get_modifier().end(); ++i) {
+      if ((*i)->needs_update()) {
+        return true;
+      }
+    }
+    return config->get_uinput().needs_update();
   }
 }
 
@@ -105,6 +149,10 @@ void UInputMessageProcessor::set_config(int num) {
   m_config->set_current_config(num);
 }
 
+void UInputMessageProcessor::set_state_export(StateExport* state_export) {
+  m_state_export = state_export;
+}
+
 void UInputMessageProcessor::set_controller(Controller* controller) {
   m_controller = controller;
   // m_config->set_controller(controller);
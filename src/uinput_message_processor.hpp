@@ -22,6 +22,7 @@
 #include "controller_slot_config.hpp"
 #include "message_processor.hpp"
 
+class StateExport;
 class UInput;
 class Options;
 class ControllerOptions;
@@ -38,16 +39,22 @@ class UInputMessageProcessor : public MessageProcessor {
   int m_rumble_gain;
   bool m_rumble_test;
   Controller* m_controller;
+  StateExport* m_state_export;
 
  public:
   UInputMessageProcessor(UInput& uinput, ControllerSlotConfigPtr config,
                          const Options& opts);
   ~UInputMessageProcessor();
 
-  void send(const XboxGenericMsg& msg, int msec_delta);
+  void send(const XboxGenericMsg& msg, int64_t time, int64_t nsec_delta);
+  void send_keys(const std::vector<ControllerKey>& keys, int64_t time);
+  bool needs_update() const;
   void set_rumble(uint8_t lhs, uint8_t rhs);
   virtual void set_controller(Controller* controller);
   void set_config(int num);
+
+  /** Publishes the state after the modifiers ran through \a state_export */
+  void set_state_export(StateExport* state_export);
   ControllerSlotConfigPtr get_config() const { return m_config; }
 
  private:
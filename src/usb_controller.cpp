@@ -18,6 +18,7 @@
 
 #include "usb_controller.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <format>
@@ -29,10 +30,21 @@
 #include "usb_helper.hpp"
 #include "xboxmsg.hpp"
 
+namespace {
+
+// usb_control() keeps finished transfers for requests up to this
+// length and reuses them, longer ones are allocated per request
+const uint16_t kMaxPooledControlLength = 64;
+
+}  // namespace
+
 USBController::USBController(libusb_device* dev)
     : m_dev(dev),
       m_handle(0),
       m_transfers(),
+      m_read_callbacks(),
+      m_control_callbacks(),
+      m_free_control_transfers(),
       m_interfaces(),
       m_usbpath(),
       m_usbid(),
@@ -96,6 +108,12 @@ USBController::~USBController() {
     }
   }
 
+  for (std::vector<libusb_transfer*>::iterator it =
+           m_free_control_transfers.begin();
+       it != m_free_control_transfers.end(); ++it) {
+    libusb_free_transfer(*it);
+  }
+
   // release all claimed interfaces
   for (std::set<int>::iterator it = m_interfaces.begin();
        it != m_interfaces.end(); ++it) {
@@ -119,6 +137,11 @@ bool USBController::parse(uint8_t* data, int len, XboxGenericMsg* msg_out) {
 }
 
 void USBController::usb_submit_read(int endpoint, int len) {
+  usb_submit_read(endpoint, len, ReadCallback());
+}
+
+void USBController::usb_submit_read(int endpoint, int len,
+                                    const ReadCallback& callback) {
   if (m_is_disconnected) {
     return;
   }
@@ -139,6 +162,9 @@ void USBController::usb_submit_read(int endpoint, int len) {
                     "libusb_submit_transfer(): " << usb_strerror(ret));
   } else {
     m_transfers.insert(transfer);
+    if (callback) {
+      m_read_callbacks[transfer] = callback;
+    }
   }
 }
 
@@ -172,19 +198,31 @@ void USBController::usb_write(int endpoint, uint8_t* data_in, int len) {
 
 void USBController::usb_control(uint8_t bmRequestType, uint8_t bRequest,
                                 uint16_t wValue, uint16_t wIndex,
-                                uint8_t* data_in, uint16_t wLength) {
+                                uint8_t* data_in, uint16_t wLength,
+                                const ControlCallback& callback) {
   if (m_is_disconnected) {
     return;
   }
 
-  libusb_transfer* transfer = libusb_alloc_transfer(0);
-  transfer->flags |= LIBUSB_TRANSFER_FREE_BUFFER;
+  libusb_transfer* transfer;
+  if (wLength <= kMaxPooledControlLength && !m_free_control_transfers.empty()) {
+    transfer = m_free_control_transfers.back();
+    m_free_control_transfers.pop_back();
+  } else {
+    transfer = libusb_alloc_transfer(0);
+    transfer->flags |= LIBUSB_TRANSFER_FREE_BUFFER;
+    transfer->buffer = static_cast<uint8_t*>(
+        malloc(LIBUSB_CONTROL_SETUP_SIZE +
+               std::max(wLength, kMaxPooledControlLength)));
+  }
 
-  // create and fill control buffer
-  uint8_t* data = static_cast<uint8_t*>(malloc(wLength + 8));
+  // fill control buffer
+  uint8_t* data = transfer->buffer;
   libusb_fill_control_setup(data, bmRequestType, bRequest, wValue, wIndex,
                             wLength);
-  memcpy(data + 8, data_in, wLength);
+  if (wLength) {
+    memcpy(data + LIBUSB_CONTROL_SETUP_SIZE, data_in, wLength);
+  }
   libusb_fill_control_transfer(transfer, m_handle, data,
                                &USBController::on_control_wrap, this, 0);
 
@@ -196,14 +234,37 @@ void USBController::usb_control(uint8_t bmRequestType, uint8_t bRequest,
                     "libusb_submit_transfer(): " << usb_strerror(ret));
   } else {
     m_transfers.insert(transfer);
+    if (callback) {
+      m_control_callbacks[transfer] = callback;
+    }
   }
 }
 
 void USBController::on_control(libusb_transfer* transfer) {
   log_debug("control transfer");
 
+  libusb_transfer_status status = transfer->status;
+
+  ControlCallback callback;
+  std::map<libusb_transfer*, ControlCallback>::iterator it =
+      m_control_callbacks.find(transfer);
+  if (it != m_control_callbacks.end()) {
+    callback.swap(it->second);
+    m_control_callbacks.erase(it);
+  }
+
   m_transfers.erase(transfer);
-  libusb_free_transfer(transfer);
+  if (transfer->length <=
+      LIBUSB_CONTROL_SETUP_SIZE + kMaxPooledControlLength) {
+    m_free_control_transfers.push_back(transfer);
+  } else {
+    libusb_free_transfer(transfer);
+  }
+
+  // the transfer is free again, so the callback can send the next one
+  if (callback && !m_is_disconnected) {
+    callback(status);
+  }
 }
 
 void USBController::on_write_data(libusb_transfer* transfer) {
@@ -226,17 +287,25 @@ void USBController::on_read_data(libusb_transfer* transfer) {
   assert(transfer);
 
   switch (transfer->status) {
-    case LIBUSB_TRANSFER_COMPLETED:
+    case LIBUSB_TRANSFER_COMPLETED: {
       // process data
-      XboxGenericMsg msg;
-      if (parse(transfer->buffer, transfer->actual_length, &msg)) {
-        submit_msg(msg);
+      std::map<libusb_transfer*, ReadCallback>::iterator it =
+          m_read_callbacks.find(transfer);
+      if (it != m_read_callbacks.end()) {
+        if (!m_is_disconnected) {
+          it->second(transfer->buffer, transfer->actual_length);
+        }
+      } else {
+        XboxGenericMsg msg;
+        if (parse(transfer->buffer, transfer->actual_length, &msg)) {
+          submit_msg(msg);
+        }
       }
       break;
+    }
 
     case LIBUSB_TRANSFER_NO_DEVICE:
-      m_transfers.erase(transfer);
-      libusb_free_transfer(transfer);
+      free_transfer(transfer);
       send_disconnect();
       return;
 
@@ -248,21 +317,25 @@ void USBController::on_read_data(libusb_transfer* transfer) {
   }
 
   if (m_is_disconnected) {
-    m_transfers.erase(transfer);
-    libusb_free_transfer(transfer);
+    free_transfer(transfer);
   } else {
     int ret;
     ret = libusb_submit_transfer(transfer);
     if (ret != LIBUSB_SUCCESS)  // could also check for LIBUSB_ERROR_NO_DEVICE
     {
       log_error("failed to resubmit USB transfer: " << usb_strerror(ret));
-      m_transfers.erase(transfer);
-      libusb_free_transfer(transfer);
+      free_transfer(transfer);
       send_disconnect();
     }
   }
 }
 
+void USBController::free_transfer(libusb_transfer* transfer) {
+  m_transfers.erase(transfer);
+  m_read_callbacks.erase(transfer);
+  libusb_free_transfer(transfer);
+}
+
 void USBController::usb_claim_interface(int ifnum, bool try_detach) {
   // keep track of all claimed interfaces so they can be released in
   // the destructor
@@ -21,18 +21,35 @@
 
 #include <libusb.h>
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "controller.hpp"
 
 class USBController : public Controller {
+ public:
+  /** Gets each report read by usb_submit_read() with a callback */
+  typedef std::function<void(uint8_t* data, int len)> ReadCallback;
+  /** Gets the status of a finished usb_control() */
+  typedef std::function<void(libusb_transfer_status status)> ControlCallback;
+
  protected:
   libusb_device* m_dev;
   libusb_device_handle* m_handle;
 
+  /** all submitted transfers, cancelled in ~USBController(), their
+      callbacks aren't called anymore from then on */
   std::set<libusb_transfer*> m_transfers;
+  std::map<libusb_transfer*, ReadCallback> m_read_callbacks;
+  std::map<libusb_transfer*, ControlCallback> m_control_callbacks;
+
+  /** finished control transfers, reused by usb_control() */
+  std::vector<libusb_transfer*> m_free_control_transfers;
+
   std::set<int> m_interfaces;
 
   std::string m_usbpath;
@@ -56,11 +73,18 @@ class USBController : public Controller {
 
   void usb_submit_read(int endpoint, int len);
 
+  /** Reads \a endpoint like the above, but passes the reports to
+      \a callback instead of parse() */
+  void usb_submit_read(int endpoint, int len, const ReadCallback& callback);
+
   void usb_write(int endpoint, uint8_t* data, int len);
   void usb_control(uint8_t bmRequestType, uint8_t bRequest, uint16_t wValue,
-                   uint16_t wIndex, uint8_t* data, uint16_t len);
+                   uint16_t wIndex, uint8_t* data, uint16_t len,
+                   const ControlCallback& callback = ControlCallback());
 
  private:
+  void free_transfer(libusb_transfer* transfer);
+
   void on_read_data(libusb_transfer* transfer);
   static void on_read_data_wrap(libusb_transfer* transfer) {
     static_cast<USBController*>(transfer->user_data)->on_read_data(transfer);
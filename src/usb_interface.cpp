@@ -28,10 +28,13 @@
 struct USBReadCallback {
   USBInterface* iface;
   std::function<bool(uint8_t*, int)> callback;
+  // set by cancel_transfer(), a transfer that completes before the
+  // cancel takes effect must not be resubmitted either
+  bool cancelled;
 
   USBReadCallback(USBInterface* iface_,
                   std::function<bool(uint8_t*, int)> callback_)
-      : iface(iface_), callback(callback_) {}
+      : iface(iface_), callback(callback_), cancelled(false) {}
 
  private:
   USBReadCallback(const USBReadCallback&);
@@ -41,10 +44,12 @@ struct USBReadCallback {
 struct USBWriteCallback {
   USBInterface* iface;
   std::function<bool(libusb_transfer*)> callback;
+  // see USBReadCallback
+  bool cancelled;
 
   USBWriteCallback(USBInterface* iface_,
                    std::function<bool(libusb_transfer*)> callback_)
-      : iface(iface_), callback(callback_) {}
+      : iface(iface_), callback(callback_), cancelled(false) {}
 
  private:
   USBWriteCallback(const USBWriteCallback&);
@@ -114,7 +119,7 @@ void USBInterface::submit_read(
                     "libusb_submit_transfer(): " << usb_strerror(ret));
   } else {
     // transfer is send on its way, so store it
-    m_endpoints[endpoint | LIBUSB_ENDPOINT_IN] = transfer;
+    m_endpoints.insert(std::make_pair(endpoint | LIBUSB_ENDPOINT_IN, transfer));
   }
 }
 
@@ -140,20 +145,34 @@ void USBInterface::submit_write(
     raise_exception(std::runtime_error,
                     "libusb_submit_transfer(): " << usb_strerror(ret));
   } else {
-    m_endpoints[endpoint | LIBUSB_ENDPOINT_OUT] = transfer;
+    m_endpoints.insert(
+        std::make_pair(endpoint | LIBUSB_ENDPOINT_OUT, transfer));
   }
 }
 
 void USBInterface::cancel_transfer(int endpoint) {
-  Endpoints::iterator it = m_endpoints.find(endpoint);
-  if (it == m_endpoints.end()) {
-    raise_exception(std::runtime_error,
-                    "endpoint " << (endpoint & LIBUSB_ENDPOINT_ADDRESS_MASK)
-                                << "not found");
-  } else {
+  // the transfers are freed once libusb reports them back, freeing
+  // them here would pull the buffers out from under the kernel
+  std::pair<Endpoints::iterator, Endpoints::iterator> range =
+      m_endpoints.equal_range(endpoint);
+  for (Endpoints::iterator it = range.first; it != range.second; ++it) {
+    if (endpoint & LIBUSB_ENDPOINT_IN) {
+      static_cast<USBReadCallback*>(it->second->user_data)->cancelled = true;
+    } else {
+      static_cast<USBWriteCallback*>(it->second->user_data)->cancelled = true;
+    }
     libusb_cancel_transfer(it->second);
-    libusb_free_transfer(it->second);
-    m_endpoints.erase(it);
+  }
+}
+
+void USBInterface::erase_transfer(libusb_transfer* transfer) {
+  std::pair<Endpoints::iterator, Endpoints::iterator> range =
+      m_endpoints.equal_range(transfer->endpoint);
+  for (Endpoints::iterator it = range.first; it != range.second; ++it) {
+    if (it->second == transfer) {
+      m_endpoints.erase(it);
+      return;
+    }
   }
 }
 
@@ -167,7 +186,8 @@ void USBInterface::cancel_write(int endpoint) {
 
 void USBInterface::on_read_data(USBReadCallback* callback,
                                 libusb_transfer* transfer) {
-  if (callback->callback(transfer->buffer, transfer->actual_length)) {
+  if (!callback->cancelled &&
+      callback->callback(transfer->buffer, transfer->actual_length)) {
     // callback returned true, thus resend the transfer
     int ret;
     ret = libusb_submit_transfer(transfer);
@@ -177,16 +197,16 @@ void USBInterface::on_read_data(USBReadCallback* callback,
                       "libusb_submit_transfer(): " << usb_strerror(ret));
     }
   } else {
-    // callback returned false, thus doing cleanup
+    // cancelled or callback returned false, thus doing cleanup
     delete callback;
+    erase_transfer(transfer);
     libusb_free_transfer(transfer);
-    m_endpoints.erase(transfer->endpoint);
   }
 }
 
 void USBInterface::on_write_data(USBWriteCallback* callback,
                                  libusb_transfer* transfer) {
-  if (callback->callback(transfer)) {
+  if (!callback->cancelled && callback->callback(transfer)) {
     // callback returned true, thus resend the transfer (user is free
     // to fill it with new data)
     int ret;
@@ -197,10 +217,10 @@ void USBInterface::on_write_data(USBWriteCallback* callback,
                       "libusb_submit_transfer(): " << usb_strerror(ret));
     }
   } else {
-    // callback returned false, thus doing cleanup
+    // cancelled or callback returned false, thus doing cleanup
     delete callback;
+    erase_transfer(transfer);
     libusb_free_transfer(transfer);
-    m_endpoints.erase(transfer->endpoint);
   }
 }
 
@@ -31,7 +31,8 @@ class USBInterface {
  private:
   libusb_device_handle* m_handle;
   int m_interface;
-  typedef std::map<int, libusb_transfer*> Endpoints;
+  // an endpoint can have several transfers in flight
+  typedef std::multimap<int, libusb_transfer*> Endpoints;
   Endpoints m_endpoints;
 
  public:
@@ -41,6 +42,9 @@ class USBInterface {
 
   void submit_read(int endpoint, int len,
                    const std::function<bool(uint8_t*, int)>& callback);
+
+  /** Cancels all transfers of the endpoint, their callbacks aren't
+      called anymore, it is no error if none are in flight */
   void cancel_read(int endpoint);
 
   // FIXME: could add a prepare_write() that does what submit_write()
@@ -48,10 +52,13 @@ class USBInterface {
   // it as argument
   void submit_write(int endpoint, uint8_t* data, int len,
                     const std::function<bool(libusb_transfer*)>& callback);
+
+  /** Same as cancel_read() for the write transfers of the endpoint */
   void cancel_write(int endpoint);
 
  private:
   void cancel_transfer(int endpoint);
+  void erase_transfer(libusb_transfer* transfer);
 
   void on_read_data(USBReadCallback* callback, libusb_transfer* transfer);
   void on_write_data(USBWriteCallback* callback, libusb_transfer* transfer);
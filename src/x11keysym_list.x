@@ -0,0 +1,116 @@
+// builtin X11 keysym to evdev keycode table, matches the first keysym
+// of each key in a standard US layout, used when no X11 display is
+// available to query the real keyboard mapping
+
+  {"XK_Escape", KEY_ESC},
+  {"XK_1", KEY_1},
+  {"XK_2", KEY_2},
+  {"XK_3", KEY_3},
+  {"XK_4", KEY_4},
+  {"XK_5", KEY_5},
+  {"XK_6", KEY_6},
+  {"XK_7", KEY_7},
+  {"XK_8", KEY_8},
+  {"XK_9", KEY_9},
+  {"XK_0", KEY_0},
+  {"XK_minus", KEY_MINUS},
+  {"XK_equal", KEY_EQUAL},
+  {"XK_BackSpace", KEY_BACKSPACE},
+  {"XK_Tab", KEY_TAB},
+  {"XK_q", KEY_Q},
+  {"XK_w", KEY_W},
+  {"XK_e", KEY_E},
+  {"XK_r", KEY_R},
+  {"XK_t", KEY_T},
+  {"XK_y", KEY_Y},
+  {"XK_u", KEY_U},
+  {"XK_i", KEY_I},
+  {"XK_o", KEY_O},
+  {"XK_p", KEY_P},
+  {"XK_bracketleft", KEY_LEFTBRACE},
+  {"XK_bracketright", KEY_RIGHTBRACE},
+  {"XK_Return", KEY_ENTER},
+  {"XK_Control_L", KEY_LEFTCTRL},
+  {"XK_a", KEY_A},
+  {"XK_s", KEY_S},
+  {"XK_d", KEY_D},
+  {"XK_f", KEY_F},
+  {"XK_g", KEY_G},
+  {"XK_h", KEY_H},
+  {"XK_j", KEY_J},
+  {"XK_k", KEY_K},
+  {"XK_l", KEY_L},
+  {"XK_semicolon", KEY_SEMICOLON},
+  {"XK_apostrophe", KEY_APOSTROPHE},
+  {"XK_grave", KEY_GRAVE},
+  {"XK_Shift_L", KEY_LEFTSHIFT},
+  {"XK_backslash", KEY_BACKSLASH},
+  {"XK_z", KEY_Z},
+  {"XK_x", KEY_X},
+  {"XK_c", KEY_C},
+  {"XK_v", KEY_V},
+  {"XK_b", KEY_B},
+  {"XK_n", KEY_N},
+  {"XK_m", KEY_M},
+  {"XK_comma", KEY_COMMA},
+  {"XK_period", KEY_DOT},
+  {"XK_slash", KEY_SLASH},
+  {"XK_Shift_R", KEY_RIGHTSHIFT},
+  {"XK_KP_Multiply", KEY_KPASTERISK},
+  {"XK_Alt_L", KEY_LEFTALT},
+  {"XK_space", KEY_SPACE},
+  {"XK_Caps_Lock", KEY_CAPSLOCK},
+  {"XK_F1", KEY_F1},
+  {"XK_F2", KEY_F2},
+  {"XK_F3", KEY_F3},
+  {"XK_F4", KEY_F4},
+  {"XK_F5", KEY_F5},
+  {"XK_F6", KEY_F6},
+  {"XK_F7", KEY_F7},
+  {"XK_F8", KEY_F8},
+  {"XK_F9", KEY_F9},
+  {"XK_F10", KEY_F10},
+  {"XK_Num_Lock", KEY_NUMLOCK},
+  {"XK_Scroll_Lock", KEY_SCROLLLOCK},
+  {"XK_KP_Home", KEY_KP7},
+  {"XK_KP_Up", KEY_KP8},
+  {"XK_KP_Prior", KEY_KP9},
+  {"XK_KP_Subtract", KEY_KPMINUS},
+  {"XK_KP_Left", KEY_KP4},
+  {"XK_KP_Begin", KEY_KP5},
+  {"XK_KP_Right", KEY_KP6},
+  {"XK_KP_Add", KEY_KPPLUS},
+  {"XK_KP_End", KEY_KP1},
+  {"XK_KP_Down", KEY_KP2},
+  {"XK_KP_Next", KEY_KP3},
+  {"XK_KP_Insert", KEY_KP0},
+  {"XK_KP_Delete", KEY_KPDOT},
+  {"XK_less", KEY_102ND},
+  {"XK_F11", KEY_F11},
+  {"XK_F12", KEY_F12},
+  {"XK_KP_Enter", KEY_KPENTER},
+  {"XK_Control_R", KEY_RIGHTCTRL},
+  {"XK_KP_Divide", KEY_KPSLASH},
+  {"XK_Print", KEY_SYSRQ},
+  {"XK_Alt_R", KEY_RIGHTALT},
+  {"XK_Home", KEY_HOME},
+  {"XK_Up", KEY_UP},
+  {"XK_Prior", KEY_PAGEUP},
+  {"XK_Left", KEY_LEFT},
+  {"XK_Right", KEY_RIGHT},
+  {"XK_End", KEY_END},
+  {"XK_Down", KEY_DOWN},
+  {"XK_Next", KEY_PAGEDOWN},
+  {"XK_Insert", KEY_INSERT},
+  {"XK_Delete", KEY_DELETE},
+  {"XK_XF86AudioMute", KEY_MUTE},
+  {"XK_XF86AudioLowerVolume", KEY_VOLUMEDOWN},
+  {"XK_XF86AudioRaiseVolume", KEY_VOLUMEUP},
+  {"XK_XF86PowerOff", KEY_POWER},
+  {"XK_KP_Equal", KEY_KPEQUAL},
+  {"XK_Pause", KEY_PAUSE},
+  {"XK_Super_L", KEY_LEFTMETA},
+  {"XK_Super_R", KEY_RIGHTMETA},
+  {"XK_Menu", KEY_COMPOSE},
+
+/* EOF */
@@ -65,8 +65,8 @@ Xbox360Controller::Xbox360Controller(libusb_device* dev, bool chatpad,
           std::runtime_error,
           "libusb_get_config_descriptor() failed: " << usb_strerror(ret));
     } else {
-      m_chatpad.reset(new Chatpad(m_handle, desc.bcdDevice, chatpad_no_init,
-                                  chatpad_debug));
+      m_chatpad.reset(
+          new Chatpad(*this, desc.bcdDevice, chatpad_no_init, chatpad_debug));
     }
   }
 
@@ -21,30 +21,32 @@
 
 #include <libusb.h>
 
+#include <memory>
 #include <string>
 
-#include "usb_controller.hpp"
+#include "controller.hpp"
 
-struct XboxGenericMsg;
-struct XPadDevice;
+class Xbox360WirelessReceiver;
 
-class Xbox360WirelessController : public USBController {
+/** A single pad of a wireless receiver, the receiver does all the
+    USB work and feeds the decoded reports into this */
+class Xbox360WirelessController : public Controller {
  private:
-  int m_endpoint;
-  int m_interface;
-  int m_battery_status;
-  std::string m_serial;
+  std::shared_ptr<Xbox360WirelessReceiver> m_receiver;
+  int m_controller_id;
 
  public:
-  Xbox360WirelessController(libusb_device* dev, int controller_id,
-                            bool try_detach);
+  Xbox360WirelessController(
+      std::shared_ptr<Xbox360WirelessReceiver> receiver, int controller_id);
   virtual ~Xbox360WirelessController();
 
-  bool parse(uint8_t* data, int len, XboxGenericMsg* msg_out);
-
   void set_rumble_real(uint8_t left, uint8_t right);
   void set_led_real(uint8_t status);
-  uint8_t get_battery_status() const;
+  int get_battery_status() const;
+
+  std::string get_usbpath() const;
+  std::string get_usbid() const;
+  std::string get_name() const;
 
  private:
   Xbox360WirelessController(const Xbox360WirelessController&);
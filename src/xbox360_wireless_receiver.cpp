@@ -0,0 +1,435 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "xbox360_wireless_receiver.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <sstream>
+#include <stdexcept>
+
+#include "helper.hpp"
+#include "log.hpp"
+#include "raise_exception.hpp"
+#include "unpack.hpp"
+#include "usb_helper.hpp"
+#include "xbox360_wireless_controller.hpp"
+#include "xboxmsg.hpp"
+
+namespace {
+
+// FIXME: Is hardcoding those ok?
+int pad_endpoint(int pad) { return pad * 2 + 1; }
+int pad_interface(int pad) { return pad * 2; }
+
+int endpoint_pad(unsigned char endpoint) {
+  return ((endpoint & LIBUSB_ENDPOINT_ADDRESS_MASK) - 1) / 2;
+}
+
+}  // namespace
+
+Xbox360WirelessReceiver::Xbox360WirelessReceiver(libusb_device* dev,
+                                                 bool try_detach)
+    : m_dev(dev),
+      m_handle(0),
+      m_try_detach(try_detach),
+      m_is_disconnected(false),
+      m_pads(),
+      m_write_pool(),
+      m_transfers(),
+      m_usbpath(),
+      m_usbid(),
+      m_name() {
+  for (int i = 0; i < kNumPads; ++i) {
+    m_pads[i].controller = 0;
+    m_pads[i].read_transfer = 0;
+    m_pads[i].reading = false;
+    m_pads[i].claimed = false;
+    m_pads[i].connection_status = -1;
+    m_pads[i].battery_status = -1;
+  }
+
+  int ret = libusb_open(dev, &m_handle);
+  if (ret != LIBUSB_SUCCESS) {
+    raise_exception(std::runtime_error,
+                    "libusb_open() failed: " << usb_strerror(ret));
+  }
+
+  m_usbpath = std::format("{:03d}:{:03d}",
+                          static_cast<int>(libusb_get_bus_number(dev)),
+                          static_cast<int>(libusb_get_device_address(dev)));
+
+  libusb_device_descriptor desc;
+  ret = libusb_get_device_descriptor(dev, &desc);
+  if (ret == LIBUSB_SUCCESS) {
+    m_usbid = std::format("{:#04x}:{:#04x}", static_cast<int>(desc.idVendor),
+                          static_cast<int>(desc.idProduct));
+
+    char buf[1024];
+    int len = libusb_get_string_descriptor_ascii(
+        m_handle, desc.iProduct, reinterpret_cast<unsigned char*>(buf),
+        sizeof(buf));
+    if (len > 0) {
+      m_name.append(buf, len);
+    }
+  }
+}
+
+Xbox360WirelessReceiver::~Xbox360WirelessReceiver() {
+  m_is_disconnected = true;
+
+  for (int i = 0; i < kNumPads; ++i) {
+    m_pads[i].controller = 0;
+    m_pads[i].reading = false;
+  }
+
+  // cancel whatever is still in flight, usually only writes
+  for (std::set<libusb_transfer*>::iterator it = m_transfers.begin();
+       it != m_transfers.end(); ++it) {
+    libusb_cancel_transfer(*it);
+  }
+
+  struct timeval to;
+  to.tv_sec = 1;
+  to.tv_usec = 0;
+
+  while (!m_transfers.empty()) {
+    int ret = libusb_handle_events_timeout_completed(NULL, &to, NULL);
+    if (ret != 0) {
+      log_error("libusb_handle_events_timeout_completed() failure: " << ret);
+    }
+  }
+
+  for (int i = 0; i < kNumPads; ++i) {
+    if (m_pads[i].read_transfer) {
+      libusb_free_transfer(m_pads[i].read_transfer);
+    }
+
+    if (m_pads[i].claimed) {
+      libusb_release_interface(m_handle, pad_interface(i));
+    }
+  }
+
+  for (std::vector<libusb_transfer*>::iterator it = m_write_pool.begin();
+       it != m_write_pool.end(); ++it) {
+    libusb_free_transfer(*it);
+  }
+
+  libusb_close(m_handle);
+}
+
+void Xbox360WirelessReceiver::attach(int pad,
+                                     Xbox360WirelessController* controller) {
+  assert(pad >= 0 && pad < kNumPads);
+  Pad& p = m_pads[pad];
+  assert(!p.controller);
+
+  if (!p.claimed) {
+    int err = usb_claim_n_detach_interface(m_handle, pad_interface(pad),
+                                           m_try_detach);
+    if (err != 0) {
+      std::ostringstream out;
+      out << " Error couldn't claim the USB interface: " << usb_strerror(err)
+          << std::endl
+          << "Try to run 'rmmod xpad' and then xboxdrv again or start xboxdrv "
+             "with the option --detach-kernel-driver.";
+      throw std::runtime_error(out.str());
+    }
+    p.claimed = true;
+  }
+
+  if (!p.read_transfer) {
+    // allocated once, resubmitted after each report and only freed
+    // together with the receiver
+    p.read_transfer = libusb_alloc_transfer(0);
+    uint8_t* data = static_cast<uint8_t*>(malloc(kPacketSize));
+    p.read_transfer->flags |= LIBUSB_TRANSFER_FREE_BUFFER;
+    libusb_fill_interrupt_transfer(
+        p.read_transfer, m_handle, pad_endpoint(pad) | LIBUSB_ENDPOINT_IN,
+        data, kPacketSize, &Xbox360WirelessReceiver::on_read_data_wrap, this,
+        0);  // timeout
+  }
+
+  p.controller = controller;
+  p.reading = true;
+
+  if (!m_is_disconnected) {
+    int ret = libusb_submit_transfer(p.read_transfer);
+    if (ret != LIBUSB_SUCCESS) {
+      p.controller = 0;
+      p.reading = false;
+      raise_exception(std::runtime_error,
+                      "libusb_submit_transfer(): " << usb_strerror(ret));
+    } else {
+      m_transfers.insert(p.read_transfer);
+    }
+  }
+}
+
+void Xbox360WirelessReceiver::detach(int pad) {
+  assert(pad >= 0 && pad < kNumPads);
+  Pad& p = m_pads[pad];
+
+  p.controller = 0;
+  p.reading = false;
+
+  if (p.read_transfer &&
+      m_transfers.find(p.read_transfer) != m_transfers.end()) {
+    libusb_cancel_transfer(p.read_transfer);
+    wait_for(p.read_transfer);
+  }
+}
+
+void Xbox360WirelessReceiver::wait_for(libusb_transfer* transfer) {
+  struct timeval to;
+  to.tv_sec = 1;
+  to.tv_usec = 0;
+
+  while (m_transfers.find(transfer) != m_transfers.end()) {
+    int ret = libusb_handle_events_timeout_completed(NULL, &to, NULL);
+    if (ret != 0) {
+      log_error("libusb_handle_events_timeout_completed() failure: " << ret);
+    }
+  }
+}
+
+void Xbox360WirelessReceiver::write(int pad, const uint8_t* data, int len) {
+  assert(len <= kPacketSize);
+
+  if (m_is_disconnected) {
+    return;
+  }
+
+  libusb_transfer* transfer;
+  if (m_write_pool.empty()) {
+    transfer = libusb_alloc_transfer(0);
+    transfer->flags |= LIBUSB_TRANSFER_FREE_BUFFER;
+    transfer->buffer = static_cast<uint8_t*>(malloc(kPacketSize));
+  } else {
+    transfer = m_write_pool.back();
+    m_write_pool.pop_back();
+  }
+
+  memcpy(transfer->buffer, data, len);
+  libusb_fill_interrupt_transfer(transfer, m_handle,
+                                 pad_endpoint(pad) | LIBUSB_ENDPOINT_OUT,
+                                 transfer->buffer, len,
+                                 &Xbox360WirelessReceiver::on_write_data_wrap,
+                                 this, 0);  // timeout
+
+  int ret = libusb_submit_transfer(transfer);
+  if (ret != LIBUSB_SUCCESS) {
+    m_write_pool.push_back(transfer);
+    raise_exception(std::runtime_error,
+                    "libusb_submit_transfer(): " << usb_strerror(ret));
+  } else {
+    m_transfers.insert(transfer);
+  }
+}
+
+int Xbox360WirelessReceiver::get_battery_status(int pad) const {
+  assert(pad >= 0 && pad < kNumPads);
+  return m_pads[pad].battery_status;
+}
+
+void Xbox360WirelessReceiver::disconnect() {
+  if (!m_is_disconnected) {
+    m_is_disconnected = true;
+
+    for (int i = 0; i < kNumPads; ++i) {
+      if (m_pads[i].controller) {
+        m_pads[i].controller->send_disconnect();
+      }
+    }
+  }
+}
+
+void Xbox360WirelessReceiver::on_write_data(libusb_transfer* transfer) {
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    // ok
+  } else if (transfer->status == LIBUSB_TRANSFER_CANCELLED) {
+    // ok
+  } else if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+    disconnect();
+  } else {
+    log_error("USB write failure: " << transfer->length << ": "
+                                    << usb_transfer_strerror(transfer->status));
+  }
+
+  m_transfers.erase(transfer);
+  m_write_pool.push_back(transfer);
+}
+
+void Xbox360WirelessReceiver::on_read_data(libusb_transfer* transfer) {
+  assert(transfer);
+
+  int pad = endpoint_pad(transfer->endpoint);
+  assert(pad >= 0 && pad < kNumPads);
+
+  switch (transfer->status) {
+    case LIBUSB_TRANSFER_COMPLETED:
+      if (m_pads[pad].controller) {
+        parse(pad, transfer->buffer, transfer->actual_length);
+      }
+      break;
+
+    case LIBUSB_TRANSFER_CANCELLED:
+      break;
+
+    case LIBUSB_TRANSFER_NO_DEVICE:
+      m_transfers.erase(transfer);
+      disconnect();
+      return;
+
+    default:
+      log_error("USB read failure: "
+                << transfer->length << ": "
+                << usb_transfer_strerror(transfer->status));
+      break;
+  }
+
+  if (m_is_disconnected || !m_pads[pad].reading) {
+    m_transfers.erase(transfer);
+  } else {
+    int ret = libusb_submit_transfer(transfer);
+    if (ret != LIBUSB_SUCCESS) {
+      log_error("failed to resubmit USB transfer: " << usb_strerror(ret));
+      m_transfers.erase(transfer);
+      disconnect();
+    }
+  }
+}
+
+void Xbox360WirelessReceiver::set_connection_status(int pad, int status) {
+  Pad& p = m_pads[pad];
+
+  if (p.connection_status != status) {
+    p.connection_status = status;
+
+    log_info("pad " << pad << ": connection status: "
+                    << ((status & 0x80) ? "controller" : "no controller")
+                    << ((status & 0x40) ? ", headset" : ""));
+
+    if (status & 0x80) {
+      p.controller->set_led_real(p.controller->get_led());
+      p.controller->set_active(true);
+    } else {
+      // reset the controller into neutral position on disconnect
+      XboxGenericMsg msg;
+      memset(&msg, 0, sizeof(msg));
+      msg.type = XBOX_MSG_XBOX360;
+      p.controller->submit_msg(msg);
+      p.controller->set_active(false);
+    }
+  }
+}
+
+void Xbox360WirelessReceiver::parse(int pad, uint8_t* data, int len) {
+  Pad& p = m_pads[pad];
+
+  if (len == 0) {
+    // nothing to do
+  } else if (len == 2 && data[0] == 0x08) {  // Connection Status Message
+    set_connection_status(pad, data[1]);
+  } else if (len == 29) {
+    // a pad that sends reports is connected, even when its connection
+    // status got lost
+    set_connection_status(pad, std::max(p.connection_status, 0) | 0x80);
+
+    if (data[0] == 0x00 && data[1] == 0x0f && data[2] == 0x00 &&
+        data[3] == 0xf0) {  // Initial Announc Message
+      std::string serial =
+          std::format("{:#2x}:{:#2x}:{:#2x}:{:#2x}:{:#2x}:{:#2x}:{:#2x}",
+                      int(data[7]), int(data[8]), int(data[9]), int(data[10]),
+                      int(data[11]), int(data[12]), int(data[13]));
+      if (serial != p.serial) {
+        p.serial = serial;
+        log_info("pad " << pad << ": serial: " << p.serial);
+      }
+
+      if (p.battery_status != data[17]) {
+        p.battery_status = data[17];
+        log_info("pad " << pad << ": battery status: " << p.battery_status);
+      }
+    } else if (data[0] == 0x00 && data[1] == 0x01 && data[2] == 0x00 &&
+               data[3] == 0xf0 && data[4] == 0x00 &&
+               data[5] == 0x13) {  // Event message
+      XboxGenericMsg msg_out;
+      msg_out.type = XBOX_MSG_XBOX360;
+      Xbox360Msg& msg = msg_out.xbox360;
+
+      uint8_t* ptr = data + 4;
+
+      msg.type = ptr[0];
+      msg.length = ptr[1];
+
+      msg.dpad_up = unpack::bit(ptr + 2, 0);
+      msg.dpad_down = unpack::bit(ptr + 2, 1);
+      msg.dpad_left = unpack::bit(ptr + 2, 2);
+      msg.dpad_right = unpack::bit(ptr + 2, 3);
+
+      msg.start = unpack::bit(ptr + 2, 4);
+      msg.back = unpack::bit(ptr + 2, 5);
+      msg.thumb_l = unpack::bit(ptr + 2, 6);
+      msg.thumb_r = unpack::bit(ptr + 2, 7);
+
+      msg.lb = unpack::bit(ptr + 3, 0);
+      msg.rb = unpack::bit(ptr + 3, 1);
+      msg.guide = unpack::bit(ptr + 3, 2);
+      msg.dummy1 = unpack::bit(ptr + 3, 3);
+
+      msg.a = unpack::bit(ptr + 3, 4);
+      msg.b = unpack::bit(ptr + 3, 5);
+      msg.x = unpack::bit(ptr + 3, 6);
+      msg.y = unpack::bit(ptr + 3, 7);
+
+      msg.lt = ptr[4];
+      msg.rt = ptr[5];
+
+      msg.x1 = unpack::int16le(ptr + 6);
+      msg.y1 = unpack::int16le(ptr + 8);
+
+      msg.x2 = unpack::int16le(ptr + 10);
+      msg.y2 = unpack::int16le(ptr + 12);
+
+      msg.dummy2 = unpack::int32le(ptr + 14);
+      msg.dummy3 = unpack::int16le(ptr + 18);
+
+      p.controller->submit_msg(msg_out);
+    } else if (data[0] == 0x00 && data[1] == 0x00 && data[2] == 0x00 &&
+               data[3] == 0x13) {  // Battery status
+      if (p.battery_status != data[4]) {
+        p.battery_status = data[4];
+        log_info("pad " << pad << ": battery status: " << p.battery_status);
+      }
+    } else if (data[0] == 0x00 && data[1] == 0x00 && data[2] == 0x00 &&
+               data[3] == 0xf0) {
+      // 0x00 0x00 0x00 0xf0 0x00 ... is send after each button
+      // press, doesn't seem to contain any information
+    } else {
+      log_debug("unknown: " << raw2str(data, len));
+    }
+  } else {
+    log_debug("unknown: " << raw2str(data, len));
+  }
+}
+
+/* EOF */
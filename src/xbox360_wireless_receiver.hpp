@@ -0,0 +1,116 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HEADER_XBOXDRV_XBOX360_WIRELESS_RECEIVER_HPP
+#define HEADER_XBOXDRV_XBOX360_WIRELESS_RECEIVER_HPP
+
+#include <libusb.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+class Xbox360WirelessController;
+
+/** The wireless receiver serves up to four pads over one USB device,
+    each pad has its own interface with an IN and OUT endpoint. The
+    receiver owns the device handle and a fixed pool of transfers,
+    decodes the reports of all endpoints and hands the results to the
+    Xbox360WirelessController attached to the pad. Pads that aren't
+    attached cost nothing, pads that are attached but not synced only
+    cost the pending read transfer. */
+class Xbox360WirelessReceiver {
+ public:
+  enum { kNumPads = 4 };
+
+ private:
+  enum { kPacketSize = 32 };
+
+  struct Pad {
+    Xbox360WirelessController* controller;
+    libusb_transfer* read_transfer;
+    bool reading;
+    bool claimed;
+
+    // last values seen, so that only changes get logged
+    int connection_status;
+    int battery_status;
+    std::string serial;
+  };
+
+  libusb_device* m_dev;
+  libusb_device_handle* m_handle;
+  bool m_try_detach;
+  bool m_is_disconnected;
+
+  Pad m_pads[kNumPads];
+
+  /** write transfers with their own buffer, reused after completion */
+  std::vector<libusb_transfer*> m_write_pool;
+
+  /** all transfers currently submitted */
+  std::set<libusb_transfer*> m_transfers;
+
+  std::string m_usbpath;
+  std::string m_usbid;
+  std::string m_name;
+
+ public:
+  Xbox360WirelessReceiver(libusb_device* dev, bool try_detach);
+  ~Xbox360WirelessReceiver();
+
+  /** Claims the interface of pad \a pad and starts reading from it,
+      reports are passed to \a controller until detach() */
+  void attach(int pad, Xbox360WirelessController* controller);
+  void detach(int pad);
+
+  void write(int pad, const uint8_t* data, int len);
+
+  int get_battery_status(int pad) const;
+
+  std::string get_usbpath() const { return m_usbpath; }
+  std::string get_usbid() const { return m_usbid; }
+  std::string get_name() const { return m_name; }
+
+ private:
+  void parse(int pad, uint8_t* data, int len);
+  void set_connection_status(int pad, int status);
+  void disconnect();
+  void wait_for(libusb_transfer* transfer);
+
+  void on_read_data(libusb_transfer* transfer);
+  static void on_read_data_wrap(libusb_transfer* transfer) {
+    static_cast<Xbox360WirelessReceiver*>(transfer->user_data)
+        ->on_read_data(transfer);
+  }
+
+  void on_write_data(libusb_transfer* transfer);
+  static void on_write_data_wrap(libusb_transfer* transfer) {
+    static_cast<Xbox360WirelessReceiver*>(transfer->user_data)
+        ->on_write_data(transfer);
+  }
+
+ private:
+  Xbox360WirelessReceiver(const Xbox360WirelessReceiver&);
+  Xbox360WirelessReceiver& operator=(const Xbox360WirelessReceiver&);
+};
+
+#endif
+
+/* EOF */
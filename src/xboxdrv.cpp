@@ -18,7 +18,6 @@
 
 #include "xboxdrv.hpp"
 
-#include <sched.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -38,7 +37,9 @@
 #include "evdev_controller.hpp"
 #include "evdev_helper.hpp"
 #include "helper.hpp"
+#include "linux_uinput.hpp"
 #include "raise_exception.hpp"
+#include "socket_input_sink.hpp"
 #include "uinput_message_processor.hpp"
 #include "usb_gsource.hpp"
 #include "usb_helper.hpp"
@@ -172,6 +173,8 @@ void Xboxdrv::run_main(const Options& opts) {
     print_copyright();
   }
 
+  set_input_sink(opts);
+
   USBSubsystem usb_subsystem;
   XboxdrvMain xboxdrv_main(opts);
   xboxdrv_main.run();
@@ -197,11 +200,16 @@ void Xboxdrv::run_daemon(Options& opts) {
     opts.get_controller_slot().set_force_feedback(false);
   }
 
+  set_input_sink(opts);
+
   if (!opts.detach) {
     USBSubsystem usb_subsystem;
     XboxdrvDaemon daemon(opts);
     daemon.run();
   } else {
+    // the parent exits with _exit(), which doesn't wait for the log
+    // thread
+    g_logger.flush();
     pid_t pid = fork();
 
     if (pid < 0) {  // fork error
@@ -288,26 +296,10 @@ Xboxdrv::Xboxdrv() {}
 
 Xboxdrv::~Xboxdrv() {}
 
-void Xboxdrv::set_scheduling(const Options& opts) {
-  if (opts.priority == Options::kPriorityRealtime) {
-    // try to set realtime priority when root, as user there doesn't
-    // seem to be a way to increase the priority
-    log_info("enabling realtime priority scheduling");
-
-    int policy = SCHED_RR;
-
-    struct sched_param param;
-    memset(&param, 0, sizeof(struct sched_param));
-    param.sched_priority = sched_get_priority_max(policy);
-
-    // we don't try SCHED_OTHER for users as min and max priority is
-    // 0 for that, thus we can't change anything with that
-
-    int ret;
-    if ((ret = sched_setscheduler(getpid(), policy, &param)) != 0) {
-      raise_exception(std::runtime_error,
-                      "sched_setschedparam() failed: " << strerror(errno));
-    }
+void Xboxdrv::set_input_sink(const Options& opts) {
+  if (!opts.uinput_socket.empty()) {
+    LinuxUinput::set_sink(
+        std::make_shared<SocketInputSink>(opts.uinput_socket));
   }
 }
 
@@ -318,8 +310,6 @@ int Xboxdrv::main(int argc, char** argv) {
     CommandLineParser cmd_parser;
     cmd_parser.parse_args(argc, argv, &opts);
 
-    set_scheduling(opts);
-
     switch (opts.mode) {
       case Options::PRINT_HELP_DEVICES:
         run_help_devices();
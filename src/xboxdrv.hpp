@@ -46,7 +46,7 @@ class Xboxdrv {
   int main(int argc, char** argv);
 
  private:
-  void set_scheduling(const Options& opts);
+  void set_input_sink(const Options& opts);
 };
 
 #endif
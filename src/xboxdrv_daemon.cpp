@@ -21,9 +21,12 @@
 #include <dbus/dbus-glib-lowlevel.h>
 #include <dbus/dbus-glib.h>
 #include <dbus/dbus.h>
+#include <glib-unix.h>
+#include <unistd.h>
 
 #include <cassert>
 #include <cerrno>
+#include <climits>
 #include <cstring>
 #include <format>
 #include <fstream>
@@ -32,12 +35,14 @@
 #include <stdexcept>
 #include <string>
 
+#include "command_line_options.hpp"
 #include "controller.hpp"
 #include "controller_factory.hpp"
 #include "controller_slot.hpp"
 #include "dbus_subsystem.hpp"
 #include "helper.hpp"
 #include "raise_exception.hpp"
+#include "scheduling.hpp"
 #include "select.hpp"
 #include "udev_subsystem.hpp"
 #include "uinput.hpp"
@@ -99,7 +104,8 @@ XboxdrvDaemon::XboxdrvDaemon(const Options& opts)
       m_gmain(),
       m_controller_slots(),
       m_inactive_controllers(),
-      m_uinput() {
+      m_uinput(),
+      m_sighup_source_id() {
   assert(!s_current);
   s_current = this;
 
@@ -111,12 +117,17 @@ XboxdrvDaemon::XboxdrvDaemon(const Options& opts)
 
   signal(SIGINT, &XboxdrvDaemon::on_sigint);
   signal(SIGTERM, &XboxdrvDaemon::on_sigint);
+
+  m_sighup_source_id =
+      g_unix_signal_add(SIGHUP, &XboxdrvDaemon::on_sighup_wrap, this);
 }
 
 XboxdrvDaemon::~XboxdrvDaemon() {
   signal(SIGINT, NULL);
   signal(SIGTERM, NULL);
 
+  g_source_remove(m_sighup_source_id);
+
   assert(s_current);
   s_current = 0;
 
@@ -170,6 +181,10 @@ void XboxdrvDaemon::run() {
       dbus_subsystem->register_controller_slots(m_controller_slots);
     }
 
+    // only now that libusb, udev, glib and dbus have started their
+    // threads, as those would otherwise inherit the realtime priority
+    setup_input_thread_scheduling(m_opts);
+
     log_debug("launching into main loop");
     g_main_loop_run(m_gmain);
     log_debug("main loop exited");
@@ -226,7 +241,8 @@ void XboxdrvDaemon::init_uinput() {
   } else {
     log_info("starting with UInput");
 
-    m_uinput.reset(new UInput(m_opts.extra_events));
+    m_uinput.reset(new UInput(m_opts.extra_events, m_opts.rel_rate,
+                              m_opts.wheel_hi_res));
     m_uinput->set_device_names(m_opts.uinput_device_names);
     m_uinput->set_device_usbids(m_opts.uinput_device_usbids);
 
@@ -240,8 +256,8 @@ void XboxdrvDaemon::init_uinput() {
       m_controller_slots.push_back(ControllerSlotPtr(new ControllerSlot(
           m_controller_slots.size(),
           ControllerSlotConfig::create(*m_uinput, slot_count,
-                                       m_opts.extra_devices, controller->second,
-                                       NULL),
+                                       m_opts.extra_devices, m_opts.chatpad,
+                                       controller->second, NULL),
           controller->second.get_match_rules(),
           controller->second.get_led_status(), m_opts, m_uinput.get())));
       slot_count += 1;
@@ -250,11 +266,29 @@ void XboxdrvDaemon::init_uinput() {
     log_info("created " << m_controller_slots.size() << " controller slots");
 
     // After all the ControllerConfig registered their events, finish up
-    // the device creation
+    // the device creation, it continues in the background, so that the
+    // slots become usable one by one
+    m_uinput->set_created_cb(std::bind(
+        &g_idle_add, &XboxdrvDaemon::on_uinput_created_wrap, this));
     m_uinput->finish();
   }
 }
 
+void XboxdrvDaemon::on_uinput_created() {
+  try {
+    m_uinput->wait_for_devices();
+    log_info("all uinput devices created");
+
+    // write out what was held back during creation, an idle pad
+    // wouldn't trigger another sync() for a while
+    m_uinput->sync();
+  } catch (const std::exception& err) {
+    log_error("fatal exception: couldn't create uinput devices: "
+              << err.what());
+    shutdown();
+  }
+}
+
 void XboxdrvDaemon::create_pid_file() {
   if (!m_opts.pid_file.empty()) {
     log_info("writing pid file: " << m_opts.pid_file);
@@ -400,7 +434,7 @@ void XboxdrvDaemon::on_connect(ControllerSlotPtr slot) {
     args.push_back(controller->get_usbpath());
     args.push_back(controller->get_usbid());
     args.push_back(controller->get_name());
-    spawn_exe(args);
+    spawn_detached(args);
   }
 }
 
@@ -420,7 +454,7 @@ void XboxdrvDaemon::on_disconnect(ControllerSlotPtr slot) {
     args.push_back(controller->get_usbpath());
     args.push_back(controller->get_usbid());
     args.push_back(controller->get_name());
-    spawn_exe(args);
+    spawn_detached(args);
   }
 }
 
@@ -532,6 +566,132 @@ void XboxdrvDaemon::shutdown() {
   g_main_loop_quit(m_gmain);
 }
 
+void XboxdrvDaemon::reload() {
+  if (m_opts.args.empty()) {
+    raise_exception(std::runtime_error,
+                    "command line isn't known, can't reload");
+  } else if (!m_uinput) {
+    raise_exception(std::runtime_error,
+                    "started without UInput, nothing to reload");
+  }
+
+  log_info("reloading configuration");
+
+  // --detach moved the daemon to '/', but the config files might be
+  // given relative to the directory xboxdrv was started in
+  char cwd[PATH_MAX];
+  if (!getcwd(cwd, sizeof(cwd))) {
+    raise_exception(std::runtime_error,
+                    "couldn't get working directory: " << strerror(errno));
+  }
+
+  if (!m_opts.working_directory.empty() &&
+      chdir(m_opts.working_directory.c_str()) != 0) {
+    raise_exception(std::runtime_error, "couldn't change to "
+                                            << m_opts.working_directory << ": "
+                                            << strerror(errno));
+  }
+
+  std::vector<char*> argv;
+  for (std::vector<std::string>::const_iterator i = m_opts.args.begin();
+       i != m_opts.args.end(); ++i) {
+    argv.push_back(const_cast<char*>(i->c_str()));
+  }
+  argv.push_back(NULL);
+
+  Options opts;
+  try {
+    CommandLineParser cmd_parser;
+    cmd_parser.parse_args(static_cast<int>(m_opts.args.size()), &argv[0],
+                          &opts);
+  } catch (...) {
+    if (chdir(cwd) != 0) {
+      log_warn("couldn't change back to " << cwd << ": " << strerror(errno));
+    }
+    throw;
+  }
+
+  if (chdir(cwd) != 0) {
+    log_warn("couldn't change back to " << cwd << ": " << strerror(errno));
+  }
+
+  if (opts.mode != Options::RUN_DAEMON) {
+    raise_exception(std::runtime_error,
+                    "command line no longer starts a daemon, not reloading");
+  } else if (opts.controller_slots.size() != m_controller_slots.size()) {
+    raise_exception(std::runtime_error,
+                    "number of controller slots changed, restart xboxdrv to "
+                    "apply that");
+  }
+
+  // same as in Xboxdrv::run_daemon()
+  opts.get_controller_slot().set_force_feedback(false);
+
+  // build the new configuration next to the running one, nothing
+  // below touches the active slots until all of it succeeded
+  std::shared_ptr<UInput> uinput(
+      new UInput(opts.extra_events, opts.rel_rate, opts.wheel_hi_res));
+  uinput->set_device_names(opts.uinput_device_names);
+  uinput->set_device_usbids(opts.uinput_device_usbids);
+
+  std::vector<ControllerSlotConfigPtr> configs;
+  int slot_count = 0;
+  for (Options::ControllerSlots::const_iterator controller =
+           opts.controller_slots.begin();
+       controller != opts.controller_slots.end(); ++controller) {
+    configs.push_back(ControllerSlotConfig::create(
+        *uinput, slot_count, opts.extra_devices, opts.chatpad,
+        controller->second, NULL));
+    slot_count += 1;
+  }
+
+  // the devices taken over must exist as well
+  m_uinput->wait_for_devices();
+  uinput->reuse_devices(*m_uinput);
+  uinput->finish();
+  uinput->wait_for_devices();
+
+  // the controllers are serviced from this main loop, so the switch
+  // below happens between two frames; release everything the old
+  // configuration holds down first, so nothing gets stuck
+  for (ControllerSlots::iterator i = m_controller_slots.begin();
+       i != m_controller_slots.end(); ++i) {
+    if ((*i)->is_connected() && !(*i)->get_config()->empty()) {
+      (*i)->get_config()->get_config()->get_uinput().reset_all_outputs();
+    }
+  }
+  m_uinput->sync();
+
+  Options::ControllerSlots::const_iterator controller =
+      opts.controller_slots.begin();
+  for (ControllerSlots::size_type i = 0; i < m_controller_slots.size();
+       ++i, ++controller) {
+    ControllerSlotPtr& slot = m_controller_slots[i];
+
+    // stay with the config the user switched to, if it still exists
+    int current_config = slot->get_config()->get_current_config();
+    if (current_config < configs[i]->config_count()) {
+      configs[i]->set_current_config(current_config);
+    }
+
+    slot->reconfigure(configs[i], controller->second.get_match_rules(),
+                      controller->second.get_led_status(), uinput.get());
+  }
+
+  // releases the devices that weren't reused
+  m_uinput = uinput;
+
+  log_info("configuration reloaded");
+}
+
+void XboxdrvDaemon::on_sighup() {
+  try {
+    reload();
+  } catch (const std::exception& err) {
+    log_error("failed to reload configuration: " << err.what());
+  }
+}
+
 void XboxdrvDaemon::on_sigint(int) { XboxdrvDaemon::current()->shutdown(); }
 
 /* EOF */
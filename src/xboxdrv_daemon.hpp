@@ -53,6 +53,8 @@ class XboxdrvDaemon {
 
   std::shared_ptr<UInput> m_uinput;
 
+  guint m_sighup_source_id;
+
  private:
   static void on_sigint(int);
   static XboxdrvDaemon* current() { return s_current; }
@@ -66,6 +68,11 @@ class XboxdrvDaemon {
   std::string status();
   void shutdown();
 
+  /** Parses the command line and config files again and switches all
+      controller slots over to the result, uinput devices are only
+      recreated when their events changed */
+  void reload();
+
  private:
   void create_pid_file();
   void init_uinput();
@@ -86,6 +93,7 @@ class XboxdrvDaemon {
 
   void on_controller_disconnect();
   void on_controller_activate();
+  void on_uinput_created();
 
  private:
   static gboolean on_controller_disconnect_wrap(gpointer data) {
@@ -98,6 +106,18 @@ class XboxdrvDaemon {
     return false;
   }
 
+  static gboolean on_uinput_created_wrap(gpointer data) {
+    static_cast<XboxdrvDaemon*>(data)->on_uinput_created();
+    return false;
+  }
+
+  static gboolean on_sighup_wrap(gpointer data) {
+    static_cast<XboxdrvDaemon*>(data)->on_sighup();
+    return true;
+  }
+
+  void on_sighup();
+
  private:
   XboxdrvDaemon(const XboxdrvDaemon&);
   XboxdrvDaemon& operator=(const XboxdrvDaemon&);
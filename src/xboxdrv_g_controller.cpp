@@ -115,4 +115,22 @@ gboolean xboxdrv_g_controller_set_config(XboxdrvGController* self,
   }
 }
 
+gboolean xboxdrv_g_controller_get_devices(XboxdrvGController* self,
+                                         gchar*** ret, GError** error) {
+  log_info("D-Bus: xboxdrv_g_controller_get_devices(" << self << ")");
+
+  if (self->controller) {
+    std::vector<std::string> devnodes = self->controller->get_devnodes();
+    *ret = g_new0(gchar*, devnodes.size() + 1);
+    for (std::vector<std::string>::size_type i = 0; i < devnodes.size(); ++i) {
+      (*ret)[i] = g_strdup(devnodes[i].c_str());
+    }
+    return TRUE;
+  } else {
+    g_set_error(error, XBOXDRV_CONTROLLER_ERROR,
+                XBOXDRV_CONTROLLER_ERROR_FAILED, "could't access controller");
+    return FALSE;
+  }
+}
+
 /* EOF */
@@ -62,6 +62,8 @@ gboolean xboxdrv_g_controller_set_led(XboxdrvGController* self, int status,
                                       GError** error);
 gboolean xboxdrv_g_controller_set_rumble(XboxdrvGController* self, int strong,
                                          int weak, GError** error);
+gboolean xboxdrv_g_controller_get_devices(XboxdrvGController* self,
+                                         gchar*** ret, GError** error);
 
 #endif
 
@@ -21,6 +21,12 @@
 #include "log.hpp"
 #include "xboxdrv_daemon.hpp"
 
+#define XBOXDRV_DAEMON_ERROR xboxdrv_daemon_error_quark()
+#define XBOXDRV_DAEMON_ERROR_FAILED 0
+GQuark xboxdrv_daemon_error_quark() {
+  return g_quark_from_static_string("xboxdrv-daemon-error-quark");
+}
+
 /* will create xboxdrv_g_daemon_get_type and set xboxdrv_g_daemon_parent_class
  */
 G_DEFINE_TYPE(XboxdrvGDaemon, xboxdrv_g_daemon, G_TYPE_OBJECT)
@@ -61,4 +67,17 @@ gboolean xboxdrv_g_daemon_shutdown(XboxdrvGDaemon* self, GError** error) {
   return TRUE;
 }
 
+gboolean xboxdrv_g_daemon_reload(XboxdrvGDaemon* self, GError** error) {
+  log_info("D-Bus: xboxdrv_g_daemon_reload(" << self << ")");
+
+  try {
+    self->daemon->reload();
+    return TRUE;
+  } catch (const std::exception& err) {
+    g_set_error(error, XBOXDRV_DAEMON_ERROR, XBOXDRV_DAEMON_ERROR_FAILED, "%s",
+                err.what());
+    return FALSE;
+  }
+}
+
 /* EOF */
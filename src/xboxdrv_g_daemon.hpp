@@ -56,6 +56,7 @@ XboxdrvGDaemon* xboxdrv_g_daemon_new(XboxdrvDaemon* daemon);
 gboolean xboxdrv_g_daemon_status(XboxdrvGDaemon* self, gchar** ret,
                                  GError** error);
 gboolean xboxdrv_g_daemon_shutdown(XboxdrvGDaemon* self, GError** error);
+gboolean xboxdrv_g_daemon_reload(XboxdrvGDaemon* self, GError** error);
 
 #endif
 
@@ -37,6 +37,8 @@
 #include "message_processor.hpp"
 #include "options.hpp"
 #include "raise_exception.hpp"
+#include "scheduling.hpp"
+#include "state_export.hpp"
 #include "uinput.hpp"
 #include "uinput_message_processor.hpp"
 #include "usb_gsource.hpp"
@@ -50,8 +52,6 @@ XboxdrvMain::XboxdrvMain(const Options& opts)
       m_gmain(),
       m_usb_gsource(),
       m_uinput(),
-      m_jsdev_number(),
-      m_evdev_number(),
       m_use_libusb(false),
       m_dev_type(),
       m_controller() {
@@ -105,27 +105,35 @@ ControllerPtr XboxdrvMain::create_controller() {
 }
 
 void XboxdrvMain::init_controller(const ControllerPtr& controller) {
-  m_jsdev_number = UInput::find_jsdev_number();
-  m_evdev_number = UInput::find_evdev_number();
-
-  if (m_opts.get_controller_slot().get_led_status() == -1) {
-    controller->set_led(2 + m_jsdev_number % 4);
-  } else {
-    controller->set_led(m_opts.get_controller_slot().get_led_status());
-  }
-
   if (m_opts.rumble_l != -1 &&
       m_opts.rumble_r != -1) {  // Only set rumble when explicitly requested
     controller->set_rumble(m_opts.rumble_l, m_opts.rumble_r);
   }
 }
 
+void XboxdrvMain::init_led(const std::vector<std::string>& devnodes) {
+  if (m_opts.get_controller_slot().get_led_status() == -1) {
+    // light up the quadrant matching the joystick device
+    int jsdev_number = 0;
+    for (std::vector<std::string>::const_iterator i = devnodes.begin();
+         i != devnodes.end(); ++i) {
+      if (sscanf(i->c_str(), "/dev/input/js%d", &jsdev_number) == 1) {
+        break;
+      }
+    }
+    m_controller->set_led(2 + jsdev_number % 4);
+  } else {
+    m_controller->set_led(m_opts.get_controller_slot().get_led_status());
+  }
+}
+
 void XboxdrvMain::on_controller_disconnect() { shutdown(); }
 
 void XboxdrvMain::run() {
   m_controller = create_controller();
   m_controller->set_disconnect_cb(
       std::bind(&XboxdrvMain::on_controller_disconnect, this));
+  std::unique_ptr<StateExport> state_export;
   std::shared_ptr<MessageProcessor> message_proc;
   init_controller(m_controller);
 
@@ -140,31 +148,49 @@ void XboxdrvMain::run() {
       message_proc.reset(new DummyMessageProcessor);
     } else {
       log_debug("creating UInput");
-      m_uinput.reset(new UInput(m_opts.extra_events));
+      m_uinput.reset(new UInput(m_opts.extra_events, m_opts.rel_rate,
+                                m_opts.wheel_hi_res));
       m_uinput->set_device_names(m_opts.uinput_device_names);
       m_uinput->set_device_usbids(m_opts.uinput_device_usbids);
 
       log_debug("creating ControllerSlotConfig");
       ControllerSlotConfigPtr config_set = ControllerSlotConfig::create(
-          *m_uinput, 0, m_opts.extra_devices, m_opts.get_controller_slot(),
-          m_controller.get());
+          *m_uinput, 0, m_opts.extra_devices, m_opts.chatpad,
+          m_opts.get_controller_slot(), m_controller.get());
 
       // After all the ControllerConfig registered their events, finish up
       // the device creation
       log_debug("finish UInput creation");
       m_uinput->finish();
+      m_uinput->wait_for_devices();
 
-      message_proc.reset(
-          new UInputMessageProcessor(*m_uinput, config_set, m_opts));
+      UInputMessageProcessor* uinput_proc =
+          new UInputMessageProcessor(*m_uinput, config_set, m_opts);
+      if (!m_opts.export_state.empty()) {
+        state_export.reset(new StateExport(m_opts.export_state + "0"));
+        uinput_proc->set_state_export(state_export.get());
+      }
+      message_proc.reset(uinput_proc);
     }
 
+    std::vector<std::string> devnodes;
+    if (m_uinput) {
+      devnodes = m_uinput->get_devnodes(0);
+    }
+    init_led(devnodes);
+
     if (!m_opts.quiet) {
-      std::cout << "\nYour Xbox/Xbox360 controller should now be available as:"
-                << std::endl
-                << "  /dev/input/js" << m_jsdev_number << std::endl
-                << "  /dev/input/event" << m_evdev_number << std::endl;
+      if (!devnodes.empty()) {
+        std::cout
+            << "\nYour Xbox/Xbox360 controller should now be available as:"
+            << std::endl;
+        for (std::vector<std::string>::const_iterator i = devnodes.begin();
+             i != devnodes.end(); ++i) {
+          std::cout << "  " << *i << std::endl;
+        }
+      }
 
-      if (m_opts.silent) {
+      if (m_opts.silent || !m_opts.monitor.empty()) {
         std::cout << "\nPress Ctrl-C to quit" << std::endl;
       } else {
         std::cout << "\nPress Ctrl-C to quit, use '--silent' to suppress the "
@@ -180,9 +206,17 @@ void XboxdrvMain::run() {
       pid_t pid = 0;
       if (!m_opts.exec.empty()) {
         pid = spawn_exe(m_opts.exec);
+        if (pid < 0) {
+          raise_exception(std::runtime_error,
+                          "couldn't launch: " << m_opts.exec[0]);
+        }
         g_child_watch_add(pid, &XboxdrvMain::on_child_watch_wrap, this);
       }
 
+      // only now that libusb and glib have started their threads, as
+      // those would otherwise inherit the realtime priority
+      setup_input_thread_scheduling(m_opts);
+
       log_debug("launching main loop");
       g_main_loop_run(m_gmain);
 
@@ -23,6 +23,8 @@
 #include <libusb.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "controller_ptr.hpp"
 #include "xpad_device.hpp"
@@ -46,8 +48,6 @@ class XboxdrvMain {
 
   std::shared_ptr<UInput> m_uinput;
 
-  int m_jsdev_number;
-  int m_evdev_number;
   bool m_use_libusb;
 
   XPadDevice m_dev_type;
@@ -65,6 +65,7 @@ class XboxdrvMain {
   ControllerPtr create_controller();
 
   void init_controller(const ControllerPtr& controller);
+  void init_led(const std::vector<std::string>& devnodes);
 
   void print_info(libusb_device* dev, const XPadDevice& dev_type,
                   const Options& opts) const;
@@ -19,13 +19,17 @@
 #include "xboxmsg.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cctype>
 #include <format>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include "helper.hpp"
 #include "raise_exception.hpp"
+#include "symbol_table.hpp"
 
 int16_t u8_to_s16(uint8_t value) {
   // FIXME: verify this
@@ -404,6 +408,19 @@ int get_button(XboxGenericMsg& msg, XboxButton button) {
   return 0;
 }
 
+bool same_buttons(const XboxGenericMsg& lhs_in,
+                  const XboxGenericMsg& rhs_in) {
+  XboxGenericMsg lhs = lhs_in;
+  XboxGenericMsg rhs = rhs_in;
+  for (int btn = XBOX_BTN_UNKNOWN + 1; btn < XBOX_BTN_MAX; ++btn) {
+    if ((get_button(lhs, static_cast<XboxButton>(btn)) != 0) !=
+        (get_button(rhs, static_cast<XboxButton>(btn)) != 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void set_button(XboxGenericMsg& msg, XboxButton button, bool v) {
   switch (msg.type) {
     case XBOX_MSG_XBOX360:
@@ -1432,102 +1449,148 @@ void set_axis(XboxGenericMsg& msg, XboxAxis axis, int v) {
   }
 }
 
-XboxButton string2btn(const std::string& str_) {
-  std::string str = to_lower(str_);
-
-  if (str == "start") {
-    return XBOX_BTN_START;
-  } else if (str == "guide" || str == "ps") {
-    return XBOX_BTN_GUIDE;
-  } else if (str == "back" || str == "select") {
-    return XBOX_BTN_BACK;
-
-  } else if (str == "a" || str == "1" || str == "green" || str == "cross") {
-    return XBOX_BTN_A;
-  } else if (str == "b" || str == "2" || str == "red" || str == "circle") {
-    return XBOX_BTN_B;
-  } else if (str == "x" || str == "3" || str == "blue" || str == "square") {
-    return XBOX_BTN_X;
-  } else if (str == "y" || str == "4" || str == "yellow" || str == "triangle") {
-    return XBOX_BTN_Y;
-
-  } else if (str == "lb" || str == "5" || str == "orange" || str == "white" ||
-             str == "l1") {
-    return XBOX_BTN_LB;
-  } else if (str == "rb" || str == "6" || str == "black" || str == "r1") {
-    return XBOX_BTN_RB;
-
-  } else if (str == "lt" || str == "7" || str == "l2") {
-    return XBOX_BTN_LT;
-  } else if (str == "rt" || str == "8" || str == "r2") {
-    return XBOX_BTN_RT;
-
-  } else if (str == "tl" || str == "l3") {
-    return XBOX_BTN_THUMB_L;
-  } else if (str == "tr" || str == "r3") {
-    return XBOX_BTN_THUMB_R;
-
-  } else if (str == "du" || str == "up" || str == "dpad_up") {
-    return XBOX_DPAD_UP;
-  } else if (str == "dd" || str == "down" || str == "dpad_down") {
-    return XBOX_DPAD_DOWN;
-  } else if (str == "dl" || str == "left" || str == "dpad_left") {
-    return XBOX_DPAD_LEFT;
-  } else if (str == "dr" || str == "right" || str == "dpad_right") {
-    return XBOX_DPAD_RIGHT;
-
+namespace {
+
+constexpr auto xbox_button_symbols =
+    make_symbol_table(std::to_array<Symbol<XboxButton>>({
+        {"start", XBOX_BTN_START},
+        {"guide", XBOX_BTN_GUIDE},
+        {"ps", XBOX_BTN_GUIDE},
+        {"back", XBOX_BTN_BACK},
+        {"select", XBOX_BTN_BACK},
+
+        {"a", XBOX_BTN_A},
+        {"1", XBOX_BTN_A},
+        {"green", XBOX_BTN_A},
+        {"cross", XBOX_BTN_A},
+        {"b", XBOX_BTN_B},
+        {"2", XBOX_BTN_B},
+        {"red", XBOX_BTN_B},
+        {"circle", XBOX_BTN_B},
+        {"x", XBOX_BTN_X},
+        {"3", XBOX_BTN_X},
+        {"blue", XBOX_BTN_X},
+        {"square", XBOX_BTN_X},
+        {"y", XBOX_BTN_Y},
+        {"4", XBOX_BTN_Y},
+        {"yellow", XBOX_BTN_Y},
+        {"triangle", XBOX_BTN_Y},
+
+        {"lb", XBOX_BTN_LB},
+        {"5", XBOX_BTN_LB},
+        {"orange", XBOX_BTN_LB},
+        {"white", XBOX_BTN_LB},
+        {"l1", XBOX_BTN_LB},
+        {"rb", XBOX_BTN_RB},
+        {"6", XBOX_BTN_RB},
+        {"black", XBOX_BTN_RB},
+        {"r1", XBOX_BTN_RB},
+
+        {"lt", XBOX_BTN_LT},
+        {"7", XBOX_BTN_LT},
+        {"l2", XBOX_BTN_LT},
+        {"rt", XBOX_BTN_RT},
+        {"8", XBOX_BTN_RT},
+        {"r2", XBOX_BTN_RT},
+
+        {"tl", XBOX_BTN_THUMB_L},
+        {"l3", XBOX_BTN_THUMB_L},
+        {"tr", XBOX_BTN_THUMB_R},
+        {"r3", XBOX_BTN_THUMB_R},
+
+        {"du", XBOX_DPAD_UP},
+        {"up", XBOX_DPAD_UP},
+        {"dpad_up", XBOX_DPAD_UP},
+        {"dd", XBOX_DPAD_DOWN},
+        {"down", XBOX_DPAD_DOWN},
+        {"dpad_down", XBOX_DPAD_DOWN},
+        {"dl", XBOX_DPAD_LEFT},
+        {"left", XBOX_DPAD_LEFT},
+        {"dpad_left", XBOX_DPAD_LEFT},
+        {"dr", XBOX_DPAD_RIGHT},
+        {"right", XBOX_DPAD_RIGHT},
+        {"dpad_right", XBOX_DPAD_RIGHT},
+    }));
+
+constexpr auto xbox_axis_symbols =
+    make_symbol_table(std::to_array<Symbol<XboxAxis>>({
+        {"x1", XBOX_AXIS_X1},
+        {"y1", XBOX_AXIS_Y1},
+        {"x2", XBOX_AXIS_X2},
+        {"whammy", XBOX_AXIS_X2},
+        {"y2", XBOX_AXIS_Y2},
+        {"tilt", XBOX_AXIS_Y2},
+
+        {"lt", XBOX_AXIS_LT},
+        {"l2", XBOX_AXIS_LT},
+        {"rt", XBOX_AXIS_RT},
+        {"r2", XBOX_AXIS_RT},
+
+        {"dpad_x", XBOX_AXIS_DPAD_X},
+        {"dpad_y", XBOX_AXIS_DPAD_Y},
+
+        {"trigger", XBOX_AXIS_TRIGGER},
+        {"z", XBOX_AXIS_TRIGGER},
+        {"rudder", XBOX_AXIS_TRIGGER},
+
+        {"btn_a", XBOX_AXIS_A},
+        {"cross", XBOX_AXIS_A},
+        {"btn_b", XBOX_AXIS_B},
+        {"circle", XBOX_AXIS_B},
+        {"btn_x", XBOX_AXIS_X},
+        {"square", XBOX_AXIS_X},
+        {"btn_y", XBOX_AXIS_Y},
+        {"triangle", XBOX_AXIS_Y},
+
+        {"white", XBOX_AXIS_WHITE},
+        {"lb", XBOX_AXIS_WHITE},
+        {"l1", XBOX_AXIS_WHITE},
+        {"black", XBOX_AXIS_BLACK},
+        {"rb", XBOX_AXIS_BLACK},
+        {"r1", XBOX_AXIS_BLACK},
+    }));
+
+/** Lowercases \a str into \a buf, returns an empty view if \a str
+    doesn't fit, which no valid button or axis name does */
+template <std::size_t N>
+std::string_view to_lower_buf(std::string_view str, char (&buf)[N]) {
+  if (str.size() > N) {
+    return std::string_view();
   } else {
-    raise_exception(std::runtime_error,
-                    "couldn't convert string \"" + str + "\" to XboxButton");
+    for (std::string_view::size_type i = 0; i < str.size(); ++i) {
+      buf[i] = static_cast<char>(tolower(static_cast<unsigned char>(str[i])));
+    }
+    return std::string_view(buf, str.size());
   }
 }
 
-XboxAxis string2axis(const std::string& str_) {
-  std::string str = to_lower(str_);
-  if (str == "x1") {
-    return XBOX_AXIS_X1;
-  } else if (str == "y1") {
-    return XBOX_AXIS_Y1;
-
-  } else if (str == "x2" || str == "whammy") {
-    return XBOX_AXIS_X2;
-  } else if (str == "y2" || str == "tilt") {
-    return XBOX_AXIS_Y2;
-
-  } else if (str == "lt" || str == "l2") {
-    return XBOX_AXIS_LT;
-  } else if (str == "rt" || str == "r2") {
-    return XBOX_AXIS_RT;
-
-  } else if (str == "dpad_x") {
-    return XBOX_AXIS_DPAD_X;
-  } else if (str == "dpad_y") {
-    return XBOX_AXIS_DPAD_Y;
+}  // namespace
 
-  } else if (str == "trigger" || str == "z" || str == "rudder") {
-    return XBOX_AXIS_TRIGGER;
-
-  } else if (str == "btn_a" || str == "cross") {
-    return XBOX_AXIS_A;
-
-  } else if (str == "btn_b" || str == "circle") {
-    return XBOX_AXIS_B;
-
-  } else if (str == "btn_x" || str == "square") {
-    return XBOX_AXIS_X;
-
-  } else if (str == "btn_y" || str == "triangle") {
-    return XBOX_AXIS_Y;
+XboxButton string2btn(const std::string& str_) {
+  char buf[16];
+  std::string_view str = to_lower_buf(str_, buf);
 
-  } else if (str == "white" || str == "lb" || str == "l1") {
-    return XBOX_AXIS_WHITE;
+  const Symbol<XboxButton>* sym = symbol_lookup(xbox_button_symbols, str);
+  if (sym) {
+    return sym->value;
+  } else {
+    raise_exception(std::runtime_error, "couldn't convert string \""
+                                            << to_lower(str_)
+                                            << "\" to XboxButton");
+  }
+}
 
-  } else if (str == "black" || str == "rb" || str == "r1") {
-    return XBOX_AXIS_BLACK;
+XboxAxis string2axis(const std::string& str_) {
+  char buf[16];
+  std::string_view str = to_lower_buf(str_, buf);
 
+  const Symbol<XboxAxis>* sym = symbol_lookup(xbox_axis_symbols, str);
+  if (sym) {
+    return sym->value;
   } else {
-    raise_exception(std::runtime_error,
-                    "couldn't convert string \"" + str + "\" to XboxAxis");
+    raise_exception(std::runtime_error, "couldn't convert string \""
+                                            << to_lower(str_)
+                                            << "\" to XboxAxis");
   }
 }
 
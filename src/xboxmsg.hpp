@@ -284,6 +284,9 @@ void set_axis(XboxGenericMsg& msg, XboxAxis axis, int v);
 float get_axis_float(XboxGenericMsg& msg, XboxAxis axis);
 void set_axis_float(XboxGenericMsg& msg, XboxAxis axis, float v);
 
+/** Returns true if the same buttons are pressed in both messages */
+bool same_buttons(const XboxGenericMsg& lhs, const XboxGenericMsg& rhs);
+
 XboxButton string2btn(const std::string& str_);
 XboxAxis string2axis(const std::string& str_);
 std::string btn2string(XboxButton btn);
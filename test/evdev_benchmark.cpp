@@ -0,0 +1,169 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <linux/input.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "evdev_absmap.hpp"
+#include "evdev_mapper.hpp"
+
+// Feeds evdev streams through EvdevMapper the way EvdevController
+// does. Without arguments a few seconds of a 1 kHz wheel and a 1 kHz
+// mouse are generated, otherwise each argument is read as a raw
+// recording of a device, as made with 'cat /dev/input/eventX > FILE'.
+
+namespace {
+
+void push_event(std::vector<struct input_event>& events, int type, int code,
+                int value) {
+  struct input_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.type = type;
+  ev.code = code;
+  ev.value = value;
+  events.push_back(ev);
+}
+
+std::vector<struct input_event> generate_wheel(int frames) {
+  std::vector<struct input_event> events;
+  for (int i = 0; i < frames; ++i) {
+    push_event(events, EV_ABS, ABS_X,
+               32768 + static_cast<int>(30000 * sin(i * 0.001)));
+    if (i % 4 == 0) {
+      push_event(events, EV_ABS, ABS_Z, (i / 4) % 256);
+    }
+    if (i % 250 == 0) {
+      push_event(events, EV_KEY, BTN_TRIGGER, (i / 250) % 2);
+    }
+    push_event(events, EV_SYN, SYN_REPORT, 0);
+  }
+  return events;
+}
+
+std::vector<struct input_event> generate_mouse(int frames) {
+  std::vector<struct input_event> events;
+  for (int i = 0; i < frames; ++i) {
+    push_event(events, EV_REL, REL_X, (i % 7) - 3);
+    push_event(events, EV_REL, REL_Y, (i % 5) - 2);
+    push_event(events, EV_MSC, MSC_SCAN, 0x90001);
+    if (i % 500 == 0) {
+      push_event(events, EV_KEY, BTN_LEFT, (i / 500) % 2);
+    }
+    push_event(events, EV_SYN, SYN_REPORT, 0);
+  }
+  return events;
+}
+
+std::vector<struct input_event> read_recording(const char* filename) {
+  std::vector<struct input_event> events;
+  std::ifstream in(filename, std::ios::binary);
+  struct input_event ev;
+  while (in.read(reinterpret_cast<char*>(&ev), sizeof(ev))) {
+    events.push_back(ev);
+  }
+  return events;
+}
+
+void run(const char* name, const std::vector<struct input_event>& events,
+         int iterations) {
+  EvdevAbsMap absmap;
+  absmap.bind_both(ABS_X, XBOX_AXIS_X1);
+  absmap.bind_both(ABS_Y, XBOX_AXIS_Y1);
+  absmap.bind_both(ABS_Z, XBOX_AXIS_LT);
+  absmap.bind_both(ABS_RZ, XBOX_AXIS_RT);
+  absmap.bind_both(ABS_HAT0X, XBOX_AXIS_DPAD_X);
+  absmap.bind_both(ABS_HAT0Y, XBOX_AXIS_DPAD_Y);
+
+  std::map<int, XboxButton> keymap;
+  keymap[BTN_TRIGGER] = XBOX_BTN_A;
+  keymap[BTN_THUMB] = XBOX_BTN_B;
+  keymap[BTN_LEFT] = XBOX_BTN_X;
+  keymap[BTN_RIGHT] = XBOX_BTN_Y;
+
+  EvdevMapper mapper(absmap, keymap);
+
+  struct input_absinfo absinfo;
+  memset(&absinfo, 0, sizeof(absinfo));
+  absinfo.minimum = 0;
+  absinfo.maximum = 65535;
+  mapper.set_absinfo(ABS_X, absinfo);
+  mapper.set_absinfo(ABS_Y, absinfo);
+  absinfo.maximum = 255;
+  mapper.set_absinfo(ABS_Z, absinfo);
+  mapper.set_absinfo(ABS_RZ, absinfo);
+  absinfo.minimum = -1;
+  absinfo.maximum = 1;
+  mapper.set_absinfo(ABS_HAT0X, absinfo);
+  mapper.set_absinfo(ABS_HAT0Y, absinfo);
+
+  int frames = 0;
+  int submitted = 0;
+  int checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < iterations; ++n) {
+    for (std::vector<struct input_event>::const_iterator i = events.begin();
+         i != events.end(); ++i) {
+      if (i->type == EV_SYN) {
+        frames += 1;
+      }
+
+      if (mapper.process(*i)) {
+        submitted += 1;
+        checksum += mapper.get_msg().xbox360.x1;
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double nsec =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << name << ":" << std::endl;
+  std::cout << "  events:     " << events.size() * iterations << std::endl;
+  std::cout << "  frames:     " << frames << std::endl;
+  std::cout << "  submitted:  " << submitted << std::endl;
+  std::cout << "  checksum:   " << checksum << std::endl;
+  std::cout << "  per event:  " << nsec / (events.size() * iterations)
+            << " nsec" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = 20;
+
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) {
+      run(argv[i], read_recording(argv[i]), iterations);
+    }
+  } else {
+    run("wheel 1kHz", generate_wheel(10000), iterations);
+    run("mouse 1kHz", generate_mouse(10000), iterations);
+  }
+
+  return 0;
+}
+
+/* EOF */
@@ -0,0 +1,106 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "evdev_helper.hpp"
+#include "ini_builder.hpp"
+#include "ini_parser.hpp"
+#include "xboxmsg.hpp"
+
+// Generates a config similar to the templated multi-slot configs
+// used in the wild, parses it and resolves every name in it, the
+// same work CommandLineParser does on startup.
+
+class INIParserBenchmarkBuilder : public INIBuilder {
+ public:
+  int sections;
+  int pairs;
+  int checksum;
+
+  INIParserBenchmarkBuilder() : sections(0), pairs(0), checksum(0) {}
+
+  void send_section(const std::string& section) { sections += 1; }
+
+  void send_pair(const std::string& name, const std::string& value) {
+    pairs += 1;
+
+    int type;
+    int code;
+    str2event(value, type, code);
+    checksum += string2btn(name) + type + code;
+  }
+};
+
+int main(int argc, char** argv) try {
+  int slots = 16;
+  int configs = 4;
+  int iterations = (argc > 1) ? atoi(argv[1]) : 20;
+
+  const char* buttons[] = {"a",  "b",  "x",     "y",    "lb",    "rb",
+                           "lt", "rt", "start", "back", "guide", "tl",
+                           "tr", "du", "dd",    "dl",   "dr"};
+  const char* events[] = {"KEY_A",     "KEY_B",     "KEY_ENTER", "KEY_SPACE",
+                          "BTN_LEFT",  "BTN_RIGHT", "KEY_LEFT",  "KEY_RIGHT",
+                          "KEY_UP",    "KEY_DOWN",  "BTN_A",     "BTN_B",
+                          "KEY_ESC",   "KEY_TAB",   "KEY_F1",    "KEY_F12",
+                          "BTN_START"};
+  const int num_buttons = sizeof(buttons) / sizeof(buttons[0]);
+
+  std::ostringstream out;
+  for (int slot = 0; slot < slots; ++slot) {
+    for (int config = 0; config < configs; ++config) {
+      out << "# generated slot " << slot << " config " << config << "\n";
+      out << "[controller" << slot << "/config" << config << "/ui-buttonmap]\n";
+      for (int n = 0; n < 200; ++n) {
+        out << buttons[n % num_buttons] << " = "
+            << events[(n + slot + config) % num_buttons]
+            << "   # comment\n";
+      }
+      out << "\n";
+    }
+  }
+  std::string data = out.str();
+
+  INIParserBenchmarkBuilder builder;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    INIParser parser(data, builder, "benchmark");
+    parser.run();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double msec =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  std::cout << "bytes:      " << data.size() << std::endl;
+  std::cout << "sections:   " << builder.sections / iterations << std::endl;
+  std::cout << "pairs:      " << builder.pairs / iterations << std::endl;
+  std::cout << "checksum:   " << builder.checksum << std::endl;
+  std::cout << "per load:   " << msec / iterations << " msec" << std::endl;
+
+  return 0;
+} catch (const std::exception& err) {
+  std::cout << "exception: " << err.what() << std::endl;
+  return 1;
+}
+
+/* EOF */
@@ -0,0 +1,78 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+// Pushes a counting byte sequence through a RingBuffer from one thread
+// and checks it on the other side, with odd chunk sizes so that reads
+// and writes wrap around at varying offsets.
+
+int main(int argc, char** argv) {
+  const size_t total = 16 * 1024 * 1024;
+  RingBuffer ring(1000);
+
+  std::thread writer([&ring, total]() {
+    uint8_t data[61];
+    size_t pos = 0;
+    while (pos < total) {
+      size_t len = std::min(sizeof(data), total - pos);
+      for (size_t i = 0; i < len; ++i) {
+        data[i] = static_cast<uint8_t>(pos + i);
+      }
+      size_t written = 0;
+      while (written < len) {
+        size_t n = ring.write(data + written, len - written);
+        if (n == 0) {
+          std::this_thread::yield();
+        }
+        written += n;
+      }
+      pos += len;
+    }
+  });
+
+  size_t errors = 0;
+  size_t pos = 0;
+  uint8_t data[37];
+  while (pos < total) {
+    size_t len = ring.read(data, sizeof(data));
+    if (len == 0) {
+      std::this_thread::yield();
+    }
+    for (size_t i = 0; i < len; ++i) {
+      if (data[i] != static_cast<uint8_t>(pos + i)) {
+        errors += 1;
+      }
+    }
+    pos += len;
+  }
+
+  writer.join();
+
+  std::cout << "capacity: " << ring.capacity() << std::endl;
+  std::cout << "bytes:    " << pos << std::endl;
+  std::cout << "errors:   " << errors << std::endl;
+
+  return errors ? 1 : 0;
+}
+
+/* EOF */
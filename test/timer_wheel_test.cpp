@@ -0,0 +1,111 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "timer_wheel.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Schedules timers with random deadlines spanning all levels of the
+// wheel and checks that each expires exactly on its deadline, with
+// the wheel advanced only to next_deadline() like the macro engine
+// does, and then again with the wheel advanced in large leaps.
+
+namespace {
+
+int g_errors = 0;
+
+class TestTimer : public TimerWheel::Timer {
+ public:
+  TimerWheel* wheel;
+  int remaining;
+
+  TestTimer() : wheel(0), remaining(0) {}
+
+  void expire(uint64_t now) {
+    if (now != get_deadline()) {
+      std::cout << "expired at " << now << ", expected " << get_deadline()
+                << std::endl;
+      g_errors += 1;
+    }
+
+    // reschedule a few times to exercise adding from within expire()
+    if (remaining > 0) {
+      remaining -= 1;
+      wheel->add(this, now + 1 + rand() % 100000);
+    }
+  }
+};
+
+int run(bool leap) {
+  TimerWheel wheel(12345);
+  std::vector<TestTimer> timers(1000);
+  for (std::vector<TestTimer>::iterator i = timers.begin(); i != timers.end();
+       ++i) {
+    i->wheel = &wheel;
+    i->remaining = rand() % 4;
+
+    uint64_t delta = rand() % 4;
+    switch (rand() % 4) {
+      case 0: delta += rand() % 64; break;
+      case 1: delta += rand() % (64 * 64); break;
+      case 2: delta += rand() % (64 * 64 * 64); break;
+      case 3: delta += rand() % (64ull * 64 * 64 * 64 * 4); break;
+    }
+    wheel.add(&*i, wheel.get_now() + 1 + delta);
+  }
+
+  // remove a few again
+  for (int i = 0; i < 100; ++i) {
+    wheel.remove(&timers[rand() % timers.size()]);
+  }
+
+  int wakeups = 0;
+  while (!wheel.empty()) {
+    if (leap) {
+      wheel.advance(wheel.get_now() + rand() % (64 * 64 * 64));
+    } else {
+      wheel.advance(wheel.next_deadline());
+    }
+    wakeups += 1;
+  }
+
+  for (std::vector<TestTimer>::iterator i = timers.begin(); i != timers.end();
+       ++i) {
+    if (i->is_scheduled()) {
+      g_errors += 1;
+    }
+  }
+
+  return wakeups;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  srand(0);
+
+  std::cout << "wakeups: " << run(false) << std::endl;
+  std::cout << "leaps:   " << run(true) << std::endl;
+  std::cout << "errors:  " << g_errors << std::endl;
+
+  return g_errors ? 1 : 0;
+}
+
+/* EOF */
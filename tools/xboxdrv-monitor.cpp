@@ -0,0 +1,164 @@
+/*
+**  Xbox360 USB Gamepad Userspace Driver
+**  Copyright (C) 2011 Ingo Ruhnke <grumbel@gmail.com>
+**
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 3 of the License, or
+**  (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "../src/message_monitor.hpp"
+
+/** Prints the controller events that xboxdrv writes with --monitor,
+    the formatting happens here so that xboxdrv itself never waits for
+    the terminal. A restarted xboxdrv is picked up automatically. */
+
+namespace {
+
+const MonitorHeader* map_monitor(const char* filename, int* fd_out,
+                                 size_t* size_out) {
+  int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return 0;
+  }
+
+  size_t size = sizeof(MonitorHeader) + sizeof(MonitorRecord) * kMonitorRecords;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size) {
+    close(fd);
+    return 0;
+  }
+
+  void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    close(fd);
+    return 0;
+  }
+
+  const MonitorHeader* header = static_cast<const MonitorHeader*>(data);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (memcmp(header->magic, kMonitorMagic, sizeof(kMonitorMagic)) != 0 ||
+      header->record_size != sizeof(MonitorRecord) ||
+      header->num_records != kMonitorRecords) {
+    munmap(data, size);
+    close(fd);
+    return 0;
+  }
+
+  *fd_out = fd;
+  *size_out = size;
+  return header;
+}
+
+bool is_unlinked(int fd) {
+  struct stat st;
+  return fstat(fd, &st) != 0 || st.st_nlink == 0;
+}
+
+/** Reads one record, returns false if the writer overwrote it while it
+    was copied */
+bool read_record(const MonitorRecord& record, uint64_t seq,
+                 MonitorRecord* out) {
+  if (record.seq.load(std::memory_order_acquire) != seq + 1) {
+    return false;
+  } else {
+    out->time_usec = record.time_usec;
+    out->source = record.source;
+    memcpy(&out->msg, &record.msg, sizeof(out->msg));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return record.seq.load(std::memory_order_relaxed) == seq + 1;
+  }
+}
+
+void run(const char* filename) {
+  while (true) {
+    int fd;
+    size_t size;
+    const MonitorHeader* header = map_monitor(filename, &fd, &size);
+    if (!header) {
+      usleep(250 * 1000);
+      continue;
+    }
+
+    const MonitorRecord* records = reinterpret_cast<const MonitorRecord*>(
+        reinterpret_cast<const char*>(header) + sizeof(MonitorHeader));
+
+    uint64_t seq = header->write_seq.load(std::memory_order_acquire);
+    uint64_t start_usec = 0;
+    int idle = 0;
+    while (true) {
+      uint64_t write_seq = header->write_seq.load(std::memory_order_acquire);
+      if (seq == write_seq) {
+        // check now and then if xboxdrv went away
+        idle += 1;
+        if (idle % 256 == 0 && is_unlinked(fd)) {
+          break;
+        }
+        usleep(1000);
+        continue;
+      }
+
+      idle = 0;
+      if (write_seq - seq > kMonitorRecords) {
+        std::cout << "-- " << write_seq - seq - kMonitorRecords
+                  << " records lost --\n";
+        seq = write_seq - kMonitorRecords;
+      }
+
+      for (; seq != write_seq; ++seq) {
+        MonitorRecord record;
+        if (!read_record(records[seq % kMonitorRecords], seq, &record)) {
+          std::cout << "-- record " << seq << " lost --\n";
+        } else {
+          if (!start_usec) {
+            start_usec = record.time_usec;
+          }
+          std::cout << "[" << record.source << "] "
+                    << (record.time_usec - start_usec) / 1000 << "ms "
+                    << record.msg << '\n';
+        }
+      }
+      std::cout.flush();
+    }
+
+    munmap(const_cast<MonitorHeader*>(header), size);
+    close(fd);
+    std::cout << "-- " << filename << " closed --" << std::endl;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cout << "Usage: " << argv[0] << " FILE\n"
+              << "Prints the events written by 'xboxdrv --monitor FILE'"
+              << std::endl;
+    return EXIT_FAILURE;
+  } else {
+    run(argv[1]);
+    return EXIT_SUCCESS;
+  }
+}
+
+/* EOF */